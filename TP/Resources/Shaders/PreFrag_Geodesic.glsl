@@ -0,0 +1,35 @@
+// From vertex shader
+// vec3 v_Normal;
+// vec3 v_Position;
+// vec2 v_TexCoord;
+in float v_Heat;
+
+// From application
+// vec3 u_ViewPosition;
+// vec3 u_LightDirection;
+// vec3 u_LightColor;
+
+// Default phong values
+void PreFrag(out vec3 ambient, out vec3 diffuse, out vec3 specular, out float shininess)
+{
+    // Normalized distance, negative out of reach of the sources
+    if (v_Heat < 0.0)
+    {
+        ambient = vec3(0.2);
+    }
+    else
+    {
+        float distance = clamp(v_Heat, 0.0, 1.0);
+        vec3 color = vec3(1 - distance, 0.5 * distance, distance);
+
+        // Isolines every twentieth of the maximum distance
+        float stripe = fract(20.0 * distance);
+        float width = fwidth(20.0 * distance);
+        float isoline = 1.0 - smoothstep(0.0, 1.5 * width, min(stripe, 1.0 - stripe));
+        ambient = mix(color, vec3(0), isoline);
+    }
+
+    diffuse = vec3(0);
+    specular = vec3(0);
+    shininess = 1.0;
+}
\ No newline at end of file
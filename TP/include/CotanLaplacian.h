@@ -0,0 +1,115 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <cstdint>
+
+#include "TriangularMesh.h"
+
+/**
+ * @brief Cotangent Laplacian of a triangular mesh, assembled once as a sparse matrix in compressed rows (CSR).
+ * Row i holds the neighbours j of vertex i with the symmetric weights w_ij = (cot alpha_ij + cot beta_ij) / 2,
+ * and A_i is a third of the area of the faces around i (lumped mass matrix), so that Lu_i = sum_j w_ij (u_j - u_i) / A_i.
+ * The weights only depend on the positions of the vertices: they have to be assembled again once the mesh changes.
+ */
+class CotanLaplacian
+{
+public:
+    using Index = TriangularMesh::Index;
+
+    CotanLaplacian() = default;
+
+    explicit CotanLaplacian(const TriangularMesh& mesh, size_t threadCount = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Computes the weights and vertex areas of the mesh. Free vertices and the infinite vertex of a
+     * triangulation have empty rows, and infinite faces are ignored.
+     */
+    void assemble(const TriangularMesh& mesh, size_t threadCount = std::thread::hardware_concurrency());
+
+    inline size_t getVertexCount() const { return m_RowOffsets.empty() ? 0 : m_RowOffsets.size() - 1; }
+
+    inline size_t getWeightCount() const { return m_Weights.size(); }
+
+    // Third of the area of the faces around the vertex
+    inline float getVertexArea(size_t vertexIndex) const { return m_VertexAreas.at(vertexIndex); }
+
+    // Compressed rows of the matrix, for the solvers working on it
+    inline std::span<const Index> getRowOffsets() const { return m_RowOffsets; }
+    inline std::span<const Index> getColumns() const { return m_Columns; }
+    inline std::span<const float> getWeights() const { return m_Weights; }
+    inline std::span<const float> getVertexAreas() const { return m_VertexAreas; }
+
+    // Checksums of the sparsity pattern, which only changes with the topology, and of the weights and areas,
+    // which also change with the positions. Solvers caching a factorization compare them to know if it is still valid.
+    inline uint64_t getPatternChecksum() const { return m_PatternChecksum; }
+    inline uint64_t getValuesChecksum() const { return m_ValuesChecksum; }
+
+    // Vertices which keep their heat in the solvers: the fixed vertices, and the vertices without area which have no equation
+    std::vector<bool> getFixedMask(std::span<const Index> fixedVertices) const;
+
+    // Laplacian of u at one vertex, with the same interface as TriangularMesh::laplacian
+    template <typename Fn>
+    auto at(size_t vertexIndex, Fn u) const -> typename std::invoke_result<Fn, size_t>::type;
+
+    /**
+     * @brief Laplacian of a whole field, one value per vertex. Rows are split between the threads so that
+     * they all get the same number of weights.
+     */
+    void apply(std::span<const float> field, std::span<float> result, size_t threadCount = std::thread::hardware_concurrency()) const;
+    void apply(std::span<const glm::vec3> field, std::span<glm::vec3> result, size_t threadCount = std::thread::hardware_concurrency()) const;
+
+    /**
+     * @brief One backward Euler step of the heat equation du/dt = Lu: solves (M - tL) u' = M u with a conjugate
+     * gradient, preconditioned by the diagonal of the system. The step is stable whatever the time step.
+     *
+     * @param heat Heat u at the beginning of the step.
+     * @param timeStep Time step t.
+     * @param result Starting guess of the solver (the previous step is a good one), replaced by u'.
+     * @param fixedVertices Vertices which keep their heat from u, like heat sources.
+     * @param tolerance Norm of the residual at which the solver stops, relatively to the norm of M u.
+     * @return size_t Iterations count.
+     */
+    size_t diffuse(std::span<const float> heat, float timeStep, std::span<float> result, std::span<const Index> fixedVertices = {},
+        float tolerance = 1e-6f, size_t maxIterations = 1000, size_t threadCount = std::thread::hardware_concurrency()) const;
+
+private:
+    template <typename T>
+    void multiply(std::span<const T> field, std::span<T> result, size_t threadCount) const;
+
+    // Calls work(rowBegin, rowEnd) on ranges of rows with the same weights count
+    template <typename Fn>
+    void runOnRows(size_t threadCount, const Fn& work) const;
+
+    // Below this count, rows are not worth a thread
+    static constexpr size_t MinRowsPerThread = 1 << 14;
+
+    std::vector<Index> m_RowOffsets;
+    std::vector<Index> m_Columns;
+    std::vector<float> m_Weights;
+    std::vector<float> m_VertexAreas;
+
+    uint64_t m_PatternChecksum = 0;
+    uint64_t m_ValuesChecksum = 0;
+};
+
+template <typename Fn>
+auto CotanLaplacian::at(size_t vertexIndex, Fn u) const -> typename std::invoke_result<Fn, size_t>::type
+{
+    using ReturnType = typename std::invoke_result<Fn, size_t>::type;
+
+    const ReturnType ui = u(vertexIndex);
+    ReturnType laplacian = ReturnType(0);
+
+    for (Index k = m_RowOffsets.at(vertexIndex); k < m_RowOffsets.at(vertexIndex + 1); k++)
+        laplacian = laplacian + m_Weights[k] * (u(m_Columns[k]) - ui);
+
+    if (m_VertexAreas.at(vertexIndex) > 0.f)
+        laplacian = laplacian / m_VertexAreas.at(vertexIndex);
+
+    return laplacian;
+}
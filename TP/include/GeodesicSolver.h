@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <span>
+
+#include "TriangularMesh.h"
+#include "CotanLaplacian.h"
+#include "SparseCholesky.h"
+
+/**
+ * @brief Geodesic distances on a triangular mesh with the heat method (K. Crane, C. Weischedel, M. Wardetzky,
+ * "Geodesics in Heat"): heat flows from the sources for a short time, its normalized gradient gives the direction
+ * of the distance, and the distance is recovered by a Poisson solve.
+ * Both systems are factorized once for the mesh, so each query only costs four triangular solves and two passes
+ * on the faces, plus one solve per source and a last one when a part of the mesh has several sources. The heat is
+ * computed in double, since it decays about like exp(-d / h) with the distance d, and its direction is only reliable
+ * when all the cotangent weights are positive, as on a Delaunay mesh without flat triangles on its hull. Like
+ * CotanLaplacian, the solver works on a copy of the geometry, and has to be built again once the mesh changes.
+ */
+class GeodesicSolver
+{
+public:
+    using Index = TriangularMesh::Index;
+
+    GeodesicSolver() = default;
+
+    explicit GeodesicSolver(const TriangularMesh& mesh, float timeFactor = 1.f);
+
+    /**
+     * @brief Precomputes the operators of the mesh and factorizes the heat and Poisson systems.
+     *
+     * @param timeFactor Heat flows during timeFactor * h^2, where h is the mean edge length. Larger values give
+     * smoother distances.
+     */
+    void build(const TriangularMesh& mesh, float timeFactor = 1.f);
+
+    /**
+     * @brief Distance from each vertex to the nearest source, zero on all the sources. Vertices which cannot reach
+     * any source are at infinity.
+     */
+    void computeDistances(std::span<const Index> sources, std::span<float> distances) const;
+
+    inline size_t getVertexCount() const { return m_Laplacian.getVertexCount(); }
+
+private:
+    CotanLaplacian m_Laplacian;
+    SparseCholesky m_Heat;
+    SparseCholesky m_Poisson;
+
+    // Finite faces, with the gradient of the hat function of each corner, and the vector whose dot product with a
+    // face vector field gives the integrated divergence at the corner
+    std::vector<glm::vec<3, Index>> m_Faces;
+    std::vector<glm::vec3> m_CornerGradients;
+    std::vector<glm::vec3> m_CornerDivergences;
+
+    // Connected part of each vertex, each of them has one vertex fixed in the Poisson system
+    std::vector<Index> m_Parts;
+    size_t m_PartCount = 0;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Vroom/Asset/AssetData/MeshData.h>
+
+#include <vector>
+#include <span>
+
+#include "TriangularMesh.h"
+#include "CotanLaplacian.h"
+#include "SparseCholesky.h"
+
+/**
+ * @brief Heat diffusion on the vertices of a mesh, independent of its rendering. The heat lives in two arrays of
+ * one scalar per vertex: each step reads one and writes the other, then swaps them, so that no step allocates.
+ * The sources keep their heat during the steps. The simulation refers to the Laplacian it was reset with, which
+ * has to outlive it.
+ */
+class HeatSimulation
+{
+public:
+    using Index = TriangularMesh::Index;
+
+    /**
+     * @brief Starts a simulation on the vertices of the Laplacian, cold everywhere but on the sources.
+     */
+    void reset(const CotanLaplacian& laplacian, std::span<const Index> sources, float sourceHeat);
+
+    // Moves the sources, the previous ones keep their current heat
+    void setSources(std::span<const Index> sources, float sourceHeat);
+
+    // Forward Euler steps u += tLu, only stable for tiny time steps
+    void stepExplicit(float timeStep, size_t iterations);
+
+    /**
+     * @brief Backward Euler step solved by conjugate gradient, from the current heat as guess.
+     *
+     * @return size_t The number of iterations of the solver.
+     */
+    size_t stepConjugateGradient(float timeStep);
+
+    // Backward Euler step solved with the factorized system, which is only factorized again when the time step or the sources change
+    void stepCholesky(float timeStep);
+
+    bool isCholeskyFactorized(float timeStep) const;
+
+    inline size_t getFactorSize() const { return m_Cholesky.getFactorSize(); }
+
+    inline std::span<const float> getHeat() const { return m_Heat; }
+
+    // Writes the heat in the scalar channel of the vertices, the rest of the vertices is left as is
+    void copyHeatTo(std::span<vrm::Vertex> vertices) const;
+
+private:
+    // Brings the sources back to their heat after a step
+    void applySources();
+
+private:
+    const CotanLaplacian* m_Laplacian = nullptr;
+    SparseCholesky m_Cholesky;
+
+    std::vector<Index> m_Sources;
+    float m_SourceHeat = 0.f;
+
+    // Current heat and the one being computed, swapped at the end of each step
+    std::vector<float> m_Heat;
+    std::vector<float> m_NextHeat;
+};
@@ -11,6 +11,9 @@
 #include "imgui.h"
 
 #include "TriangularMesh.h"
+#include "CotanLaplacian.h"
+#include "GeodesicSolver.h"
+#include "HeatSimulation.h"
 
 class MyScene : public vrm::Scene
 {
@@ -34,6 +37,9 @@ private:
 	void showLaplacianSmooth();
 	void showCurvature();
 	void showHeatDiffusion();
+	void showHeatMesh();
+	void showGeodesicDistance();
+	void updateGeodesicDistance();
 
 	void updateHeatDiffusion(float dt);
 
@@ -50,6 +56,8 @@ private:
 
 	vrm::MeshAsset m_MeshAsset;
 	TriangularMesh m_TriangularMesh;
+	CotanLaplacian m_CotanLaplacian;
+	// Positions and normals of the smooth views, computed once
 	vrm::MeshData m_SmoothMeshData;
 
 	std::string m_ViewMode = "Flat";
@@ -58,5 +66,17 @@ private:
 	bool m_SimulationStarted = false;
 	int m_TriangleHeatSource = 10;
 	float m_HeatSourceValue = 10.f;
+	HeatSimulation m_HeatSimulation;
+	std::string m_HeatSolver = "Cholesky";
+	bool m_IsEditingHeatSystem = false;
 	int m_IterationsPerFrame = 1;
+	float m_HeatTimeStep = 0.00001f;
+	int m_LastSolverIterations = 0;
+
+	// Built on the first query, since the factorizations take a moment
+	GeodesicSolver m_GeodesicSolver;
+	bool m_IsGeodesicSolverBuilt = false;
+	int m_GeodesicSource = 0;
+	std::vector<TriangularMesh::Index> m_GeodesicSources;
+	std::vector<float> m_Distances;
 };
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+
+/**
+ * @brief Robust geometric predicates on the plane.
+ * A floating point filter gives the answer whenever its error bound allows it, otherwise
+ * the determinant sign is computed exactly with floating point expansions.
+ * The filters are inlined since they are on the triangulation hot path.
+ */
+class Predicates
+{
+public:
+    /**
+     * @brief Orientation of the triangle (a, b, c).
+     * 
+     * @return double Positive if c is on the left of (a, b) (counter clockwise), negative if it is on the right, zero if collinear.
+     * Only the sign is guaranteed to be exact.
+     */
+    static double Orient2D(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c);
+
+    /**
+     * @brief Position of d relatively to the circumcircle of the counter clockwise triangle (a, b, c).
+     * 
+     * @return double Positive if d is inside the circle, negative if outside, zero if cocircular.
+     * Only the sign is guaranteed to be exact.
+     */
+    static double InCircle(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c, const glm::dvec2& d);
+
+    // Exact versions, used when the filters fail.
+    static double Orient2DExact(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c);
+    static double InCircleExact(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c, const glm::dvec2& d);
+
+private:
+    static constexpr double Epsilon = 0x1p-53;
+    // Error bounds from J. R. Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates".
+    static constexpr double OrientErrorBound = (3.0 + 16.0 * Epsilon) * Epsilon;
+    static constexpr double InCircleErrorBound = (10.0 + 96.0 * Epsilon) * Epsilon;
+};
+
+inline double Predicates::Orient2D(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c)
+{
+    const double detLeft = (a.x - c.x) * (b.y - c.y);
+    const double detRight = (a.y - c.y) * (b.x - c.x);
+    const double det = detLeft - detRight;
+
+    // If both terms have opposite signs (or one is zero), the subtraction cannot cancel
+    double detSum;
+    if (detLeft > 0.0)
+    {
+        if (detRight <= 0.0)
+            return det;
+        detSum = detLeft + detRight;
+    }
+    else if (detLeft < 0.0)
+    {
+        if (detRight >= 0.0)
+            return det;
+        detSum = -detLeft - detRight;
+    }
+    else
+        return det;
+
+    const double errorBound = OrientErrorBound * detSum;
+    if (det >= errorBound || -det >= errorBound)
+        return det;
+
+    return Orient2DExact(a, b, c);
+}
+
+inline double Predicates::InCircle(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c, const glm::dvec2& d)
+{
+    const double adx = a.x - d.x, ady = a.y - d.y;
+    const double bdx = b.x - d.x, bdy = b.y - d.y;
+    const double cdx = c.x - d.x, cdy = c.y - d.y;
+
+    const double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    const double aLift = adx * adx + ady * ady;
+
+    const double cdxady = cdx * ady, adxcdy = adx * cdy;
+    const double bLift = bdx * bdx + bdy * bdy;
+
+    const double adxbdy = adx * bdy, bdxady = bdx * ady;
+    const double cLift = cdx * cdx + cdy * cdy;
+
+    const double det = aLift * (bdxcdy - cdxbdy)
+                     + bLift * (cdxady - adxcdy)
+                     + cLift * (adxbdy - bdxady);
+
+    const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * aLift
+                           + (std::abs(cdxady) + std::abs(adxcdy)) * bLift
+                           + (std::abs(adxbdy) + std::abs(bdxady)) * cLift;
+
+    const double errorBound = InCircleErrorBound * permanent;
+    if (det > errorBound || -det > errorBound)
+        return det;
+
+    return InCircleExact(a, b, c, d);
+}
+
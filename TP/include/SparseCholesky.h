@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <limits>
+
+#include "TriangularMesh.h"
+#include "CotanLaplacian.h"
+
+/**
+ * @brief Sparse LDL^T factorization of a system aM - tL of a cotangent Laplacian, like the backward Euler step
+ * M - tL of the heat equation or the Poisson equation -L, restricted to the vertices which are not fixed.
+ * Once factorized, each solve only costs two sparse triangular solves.
+ * The rows are reordered by nested dissection to limit the fill of the factor. The ordering and the pattern of
+ * the factor are cached for the topology and fixed vertices, and the numeric factor for the weights and time step,
+ * so that only the invalidated parts are computed again.
+ */
+class SparseCholesky
+{
+public:
+    using Index = TriangularMesh::Index;
+
+    /**
+     * @brief Factorizes aM - tL, unless the factor of the same system is cached. The values of the fixed vertices
+     * are given to each solve. Without mass, each connected part of the mesh needs a fixed vertex.
+     *
+     * @return bool True if the factor was computed again.
+     */
+    bool factorize(const CotanLaplacian& laplacian, float timeStep, std::span<const Index> fixedVertices = {}, float massFactor = 1.f);
+
+    bool isFactorized(const CotanLaplacian& laplacian, float timeStep, std::span<const Index> fixedVertices = {}, float massFactor = 1.f) const;
+
+    /**
+     * @brief One backward Euler step of the heat equation with the factorized system: solves (M - tL) u' = M u,
+     * where the fixed vertices keep their heat from u. The double version keeps heat too small for floats.
+     */
+    void diffuse(std::span<const float> heat, std::span<float> result) const;
+    void diffuse(std::span<const double> heat, std::span<double> result) const;
+
+    // Solves (aM - tL) x = b, where the fixed vertices take their values in fixedValues
+    void solve(std::span<const float> rightHandSide, std::span<const float> fixedValues, std::span<float> result) const;
+    void solve(std::span<const double> rightHandSide, std::span<const double> fixedValues, std::span<double> result) const;
+
+    void clear();
+
+    // Non zero entries of L, without its unit diagonal
+    inline size_t getFactorSize() const { return m_FactorRows.size(); }
+
+private:
+    // Elimination order of the free vertices, by recursive bisection of the matrix graph along BFS level sets
+    void computeOrdering(const CotanLaplacian& laplacian);
+
+    // Elimination tree and column counts of L
+    void computeSymbolicFactorization(const CotanLaplacian& laplacian);
+
+    // Up-looking LDL^T, one row of L at a time
+    void computeNumericFactorization(const CotanLaplacian& laplacian, float timeStep, float massFactor);
+
+    template <typename T>
+    void diffuseField(std::span<const T> heat, std::span<T> result) const;
+
+    template <typename T>
+    void solveField(std::span<const T> rightHandSide, std::span<const T> fixedValues, std::span<T> result) const;
+
+    // Solves the system for the right-hand side in elimination order, and scatters the solution
+    template <typename T>
+    void solveOrdered(std::vector<double>& x, std::span<const T> fixedValues, std::span<T> result) const;
+
+    // Parts below this size are not split anymore
+    static constexpr size_t MinDissectionSize = 16;
+
+    static constexpr Index NoParent = std::numeric_limits<Index>::max();
+
+    uint64_t m_PatternKey = 0;
+    uint64_t m_ValuesKey = 0;
+    float m_TimeStep = 0.f;
+    float m_MassFactor = 0.f;
+    bool m_HasPattern = false;
+    bool m_HasValues = false;
+
+    // Fixed vertices, and the position of each free vertex in the elimination order
+    std::vector<bool> m_IsFixed;
+    std::vector<Index> m_Order;
+    std::vector<Index> m_Rank;
+
+    // Columns of L in compressed form, and D
+    std::vector<Index> m_Parent;
+    std::vector<size_t> m_FactorOffsets;
+    std::vector<Index> m_FactorRows;
+    std::vector<double> m_FactorValues;
+    std::vector<double> m_Diagonal;
+
+    // Coefficients of the right-hand side, and rows of -tL towards the fixed vertices, moved to the right-hand side
+    std::vector<double> m_Masses;
+    std::vector<Index> m_FixedOffsets;
+    std::vector<Index> m_FixedColumns;
+    std::vector<double> m_FixedValues;
+};
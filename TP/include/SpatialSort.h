@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+class SpatialSort
+{
+public:
+    /**
+     * @brief Index of a point on a 2D Hilbert curve of order 16.
+     * 
+     * @param x First coordinate, in [0, 65535].
+     * @param y Second coordinate, in [0, 65535].
+     * @return uint32_t Distance along the curve.
+     */
+    static uint32_t HilbertIndex(uint32_t x, uint32_t y);
+
+    /**
+     * @brief Biased randomized insertion order. Points are shuffled, split into rounds of doubling sizes,
+     * and each round is sorted along a Hilbert curve on the (x, z) plane.
+     * 
+     * @param points Points to sort.
+     * @return std::vector<size_t> Indices of the points in insertion order.
+     */
+    static std::vector<size_t> BRIO(std::span<const glm::vec3> points);
+};
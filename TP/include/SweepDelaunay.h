@@ -0,0 +1,72 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+/**
+ * @brief Sweep-hull Delaunay triangulation of a static point set.
+ * Points are sorted by distance to the circumcenter of a seed triangle, and each one is connected
+ * to the visible part of the convex hull, which is located with an angular hash. Edges are then
+ * legalized with flips.
+ *
+ * Triangles are counter clockwise on the (x, -z) plane, like TriangularMesh faces.
+ */
+class SweepDelaunay
+{
+public:
+    static constexpr uint32_t Invalid = ~0u;
+
+public:
+    SweepDelaunay(std::span<const glm::vec3> points);
+
+    // Vertex indices, 3 per triangle. Half-edge h goes from triangles[h] to triangles[next(h)].
+    const std::vector<uint32_t>& getTriangles() const { return m_Triangles; }
+
+    // Opposite half-edge of each half-edge, Invalid on the convex hull.
+    const std::vector<uint32_t>& getHalfEdges() const { return m_HalfEdges; }
+
+    // First vertex of the convex hull. The hull can be walked counter clockwise with getHullNext.
+    uint32_t getHullStart() const { return m_HullStart; }
+
+    uint32_t getHullNext(uint32_t vertexIndex) const { return m_HullNext.at(vertexIndex); }
+
+    // Half-edge going from vertexIndex to getHullNext(vertexIndex), for each hull vertex.
+    uint32_t getHullHalfEdge(uint32_t vertexIndex) const { return m_HullTri.at(vertexIndex); }
+
+    // Number of points that were not triangulated because they were duplicates.
+    size_t getSkippedCount() const { return m_SkippedCount; }
+
+private:
+    uint32_t addTriangle(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t a, uint32_t b, uint32_t c);
+
+    void link(uint32_t a, uint32_t b);
+
+    void legalize(uint32_t a);
+
+    size_t hashKey(const glm::dvec2& p) const;
+
+    double orient(uint32_t i0, uint32_t i1, uint32_t i2) const;
+
+    bool inCircle(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t i3) const;
+
+private:
+    std::vector<glm::dvec2> m_Coords;
+
+    std::vector<uint32_t> m_Triangles;
+    std::vector<uint32_t> m_HalfEdges;
+
+    std::vector<uint32_t> m_HullPrev;
+    std::vector<uint32_t> m_HullNext;
+    std::vector<uint32_t> m_HullTri;
+    std::vector<uint32_t> m_HullHash;
+    uint32_t m_HullStart = Invalid;
+
+    glm::dvec2 m_Center;
+
+    std::vector<uint32_t> m_EdgeStack;
+
+    size_t m_SkippedCount = 0;
+};
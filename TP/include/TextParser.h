@@ -0,0 +1,138 @@
+#pragma once
+
+#include <string_view>
+#include <filesystem>
+#include <charconv>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <cstddef>
+
+/**
+ * @brief Read only view of a whole file mapped in memory.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return m_IsOpen; }
+
+    std::string_view getContent() const { return { m_Data, m_Size }; }
+
+private:
+    const char* m_Data = nullptr;
+    size_t m_Size = 0;
+    bool m_IsOpen = false;
+
+#ifdef _WIN32
+    void* m_File = nullptr;
+    void* m_Mapping = nullptr;
+#endif
+};
+
+/**
+ * @brief Parsing of text files without copies: lines are views on the text, and numbers are read with std::from_chars.
+ */
+class TextParser
+{
+public:
+    /**
+     * @brief Removes the first line from the text.
+     *
+     * @return std::string_view The first line, without its end of line.
+     */
+    static std::string_view NextLine(std::string_view& text);
+
+    /**
+     * @brief Reads a number after optional blanks, and moves the line after it.
+     *
+     * @return bool False if there is no number of that type at the beginning of the line.
+     */
+    template <typename T>
+    static bool ParseNumber(std::string_view& line, T& value);
+
+    /**
+     * @brief Calls parseLine(line, lineIndex) on every line of the text. The text is split in line aligned chunks,
+     * which are parsed in parallel once the lines of each chunk are counted.
+     *
+     * @return size_t Lines count.
+     */
+    template <typename Fn>
+    static size_t ParseLines(std::string_view text, Fn parseLine, size_t threadCount = std::thread::hardware_concurrency());
+
+private:
+    // Below this size, a chunk is not worth a thread
+    static constexpr size_t MinChunkSize = 1 << 16;
+};
+
+template <typename T>
+bool TextParser::ParseNumber(std::string_view& line, T& value)
+{
+    size_t start = 0;
+    while (start < line.size() && (line[start] == ' ' || line[start] == '\t' || line[start] == '\r'))
+        start++;
+
+    // std::from_chars does not accept the plus sign
+    if (start < line.size() && line[start] == '+')
+        start++;
+
+    const auto [end, error] = std::from_chars(line.data() + start, line.data() + line.size(), value);
+    if (error != std::errc())
+        return false;
+
+    line.remove_prefix(end - line.data());
+    return true;
+}
+
+template <typename Fn>
+size_t TextParser::ParseLines(std::string_view text, Fn parseLine, size_t threadCount)
+{
+    const size_t chunkCount = std::max<size_t>(1, std::min(threadCount, text.size() / MinChunkSize + 1));
+
+    // Chunks end right after an end of line
+    std::vector<size_t> bounds(chunkCount + 1, text.size());
+    bounds[0] = 0;
+    for (size_t c = 1; c < chunkCount; c++)
+    {
+        const size_t end = text.find('\n', std::max(bounds[c - 1], c * text.size() / chunkCount));
+        bounds[c] = (end == std::string_view::npos) ? text.size() : end + 1;
+    }
+
+    auto runInParallel = [chunkCount](const auto& work)
+    {
+        if (chunkCount == 1)
+            return work(0);
+
+        std::vector<std::thread> threads;
+        for (size_t c = 0; c < chunkCount; c++)
+            threads.emplace_back(work, c);
+
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    // Index of the first line of each chunk
+    std::vector<size_t> firstLines(chunkCount + 1, 0);
+    runInParallel([&](size_t c)
+    {
+        const std::string_view chunk = text.substr(bounds[c], bounds[c + 1] - bounds[c]);
+        firstLines[c + 1] = std::count(chunk.begin(), chunk.end(), '\n') + (!chunk.empty() && chunk.back() != '\n');
+    });
+
+    for (size_t c = 0; c < chunkCount; c++)
+        firstLines[c + 1] += firstLines[c];
+
+    runInParallel([&](size_t c)
+    {
+        std::string_view chunk = text.substr(bounds[c], bounds[c + 1] - bounds[c]);
+        for (size_t lineIndex = firstLines[c]; !chunk.empty(); lineIndex++)
+            parseLine(NextLine(chunk), lineIndex);
+    });
+
+    return firstLines.back();
+}
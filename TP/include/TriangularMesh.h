@@ -6,11 +6,16 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <filesystem>
 #include <functional>
 #include <type_traits>
 #include <thread>
 #include <optional>
-#include <deque>
+#include <span>
+#include <cstdint>
+#include <limits>
+#include <utility>
 
 #include <glm/glm.hpp>
 
@@ -28,29 +33,65 @@ struct std::hash<std::pair<size_t, size_t>>
     }
 };
 
+class CotanLaplacian;
+
 class TriangularMesh
 {
 public:
+    // Type of the vertex and face indices stored in the topology. 32 bits indices halve the size of the
+    // vertices and faces arrays, and match the indices of vrm::MeshData.
+#ifdef TP_64BIT_INDICES
+    using Index = uint64_t;
+#else
+    using Index = uint32_t;
+#endif
+
+    // First face of the removed vertices, until their slot is reused.
+    static constexpr Index InvalidIndex = std::numeric_limits<Index>::max();
 
     struct Vertex
     {
         glm::vec3 position;
-        size_t faceIndex;
+        Index faceIndex;
     };
 
     struct Face
     {
         union
         {
-            struct { size_t i0, i1, i2; };
-            glm::vec<3, size_t> indices;
+            struct { Index i0, i1, i2; };
+            glm::vec<3, Index> indices;
             
         };
         union
         {
-            struct { size_t n0, n1, n2; };
-            glm::vec<3, size_t> neighbours;
+            struct { Index n0, n1, n2; };
+            glm::vec<3, Index> neighbours;
         };
+        // For each neighbour, local index in that neighbour of the vertex opposite to the shared edge, on 2 bits.
+        uint8_t oppositeLocals = 0;
+        // One bit per edge, set if the edge is constrained and must not be flipped.
+        uint8_t constraints = 0;
+
+        inline glm::length_t oppositeLocal(glm::length_t localEdgeIndex) const
+        {
+            return (oppositeLocals >> (2 * localEdgeIndex)) & 0b11;
+        }
+
+        inline void setOppositeLocal(glm::length_t localEdgeIndex, glm::length_t oppositeLocalIndex)
+        {
+            oppositeLocals = static_cast<uint8_t>((oppositeLocals & ~(0b11 << (2 * localEdgeIndex))) | (oppositeLocalIndex << (2 * localEdgeIndex)));
+        }
+
+        inline bool isConstrained(glm::length_t localEdgeIndex) const
+        {
+            return (constraints >> localEdgeIndex) & 1;
+        }
+
+        inline void setConstrained(glm::length_t localEdgeIndex, bool constrained)
+        {
+            constraints = static_cast<uint8_t>((constraints & ~(1 << localEdgeIndex)) | (constrained << localEdgeIndex));
+        }
     };
 
     /**
@@ -69,9 +110,46 @@ public:
     struct Edge
     {
         // Edge indices
-        size_t e0, e1;
+        Index e0, e1;
         // Triangle indices
-        size_t t0, t1;
+        Index t0, t1;
+    };
+
+    // Edge of a face, designated by the local index of the opposite vertex.
+    struct Corner
+    {
+        Index face;
+        glm::length_t local;
+    };
+
+    // How a vertex is inserted while keeping the Delaunay property.
+    enum class InsertionKernel
+    {
+        // Face split (or hull extension), then flips of the edges that are not Delaunay anymore
+        FLIPS = 0,
+        // Removal of the faces whose circumcircle contains the vertex, then star triangulation of the cavity
+        BOWYER_WATSON
+    };
+
+    // Voronoi diagram dual to the triangulation, clipped against an axis-aligned box. Positions are in the (x, z) plane.
+    struct VoronoiDiagram
+    {
+        // Circumcenter of face i at index i (meaningless for infinite and free faces), then the points created by the clipping
+        std::vector<glm::vec2> vertices;
+        size_t circumcenterCount = 0;
+
+        // The cell of vertex i is the polygon of vertices cellVertices[cellOffsets[i]] to cellVertices[cellOffsets[i + 1] - 1],
+        // clockwise in the (x, z) plane, the faces being counterclockwise in (x, -z). Free vertices, the infinite vertex
+        // and cells outside of the box have empty cells.
+        std::vector<Index> cellOffsets;
+        std::vector<Index> cellVertices;
+
+        // The edge from cellVertices[k] to the next vertex of its cell separates it from the cell of cellNeighbours[k],
+        // or lies on the box if it is InvalidIndex.
+        std::vector<Index> cellNeighbours;
+
+        // Cell edges as thin quads at the given height, each edge shared by two cells once, the renderer only drawing triangles.
+        vrm::MeshData toMeshData(float height, float lineWidth) const;
     };
 public:
     TriangularMesh();
@@ -81,33 +159,128 @@ public:
     void clear();
 
     // Adds a vertex and returns its index.
-    size_t addVertex(const Vertex& v);
+    Index addVertex(const Vertex& v);
     
     // Adds a face with existing vertex indices and returns the index of the created face.
-    size_t addFace(size_t v0, size_t v1, size_t v2);
+    Index addFace(size_t v0, size_t v1, size_t v2);
 
-    size_t addFirstFaceForTriangulation(size_t v0, size_t v1, size_t v2);
+    // Links every face to its neighbours, and every vertex to one of its faces, from the vertex indices of the faces alone.
+    // The half-edges are bucketed by their smallest vertex, and the buckets are sorted and paired up in parallel.
+    // Edges without a twin get InvalidIndex neighbours, and the faces of a non-manifold edge are paired in index order.
+    void buildAdjacency(size_t threadCount = std::thread::hardware_concurrency());
+
+    Index addFirstFaceForTriangulation(size_t v0, size_t v1, size_t v2);
 
     void faceSplit(size_t faceIndex, const glm::vec3& vertexPosition);
 
+    // Splits the face with a vertex that was already added but is not part of the triangulation yet.
+    void faceSplit(size_t faceIndex, size_t vertexIndex);
+
     Edge edgeFlip(size_t vertexIndex0, size_t vertexIndex1);
 
+    // Flips the edge opposite to the local vertex localEdgeIndex of the face, in constant time.
+    // The face keeps that vertex, and the returned edge goes from it to the vertex of the neighbour across the old edge.
+    Edge edgeFlip(size_t faceIndex, glm::length_t localEdgeIndex);
+
     // Finds the nearest edge and performs an edge flip.
     void edgeFlip(const glm::vec3& coords);
 
+    // Splits the edge opposite to the local vertex localEdgeIndex of the face, and the neighbour across it,
+    // with a vertex that was already added and lies on that edge.
+    void edgeSplit(size_t faceIndex, glm::length_t localEdgeIndex, size_t vertexIndex);
+
+    // Removes the vertex and fills its hole with Delaunay triangles, at a cost that only depends on the vertex degree.
+    // The slots of the vertex and of the two faces that are not needed anymore are reused by the next insertions.
+    void removeVertex(size_t vertexIndex);
+
+    // Removes the nearest vertex of the face containing the point.
+    void removeVertex(const glm::vec3& coords);
+
+    inline bool isVertexFree(size_t vertexIndex) const { return m_Vertices.at(vertexIndex).faceIndex == InvalidIndex; }
+
+    inline bool isVertexInfinite(size_t vertexIndex) const { return m_IsForTriangulation && vertexIndex == m_InfiniteVertexIndex; }
+
+    // Forces the segment between the two vertices into the triangulation, as an edge that is never flipped.
+    // Only the triangles crossed by the segment are replaced, by the constrained Delaunay triangulation of both sides.
+    // Returns false if the segment crosses another constrained edge, and then leaves the triangulation unchanged.
+    bool insertConstraint(size_t vertexIndex0, size_t vertexIndex1);
+
+    // Inserts the segments of a breaklines file: a first line with the segments count, then the indices of two points
+    // on each line, turned into vertex indices by vertexIndex if given. Malformed lines, and segments which do not join
+    // two triangulated vertices, are skipped with a warning giving their line. Returns the number of inserted segments,
+    // out of segmentCount non blank lines.
+    size_t insertBreaklines(const std::filesystem::path& path, const std::function<size_t(size_t)>& vertexIndex = nullptr, size_t* segmentCount = nullptr);
+
+    bool isEdgeConstrained(size_t faceIndex, glm::length_t localEdgeIndex) const;
+
     bool isFaceInfinite(size_t faceIndex) const;
 
-    std::optional<size_t> getFaceContainingPoint(const glm::vec3& vertexPosition) const;
+    // Walks from hintFaceIndex (by default, a face of the last added vertex) towards the point.
+    // Returns the face containing the point, or the infinite face behind the hull edge the walk exits through.
+    // If blockingConstraint is given, the walk stops in front of the first constrained edge it would cross, and stores it there.
+    Index locateFace(const glm::vec3& vertexPosition, std::optional<size_t> hintFaceIndex = std::nullopt, std::optional<Corner>* blockingConstraint = nullptr) const;
+
+    // Keeps a Delaunay hierarchy: coarser triangulations of random samples of the vertices (one out of HierarchyRatio
+    // per level), linked level to level. Locations without hint and streaming insertions then descend from the coarsest
+    // level instead of walking across the whole mesh, in expected O(log n).
+    // Levels are only used as location hints, so the other edits of the mesh do not break them.
+    void setHierarchyEnabled(bool enabled);
+
+    inline bool isHierarchyEnabled() const { return m_IsHierarchyEnabled; }
+
+    inline size_t getHierarchyLevelCount() const { return m_HierarchyLevels.size(); }
+
+    std::optional<Index> getFaceContainingPoint(const glm::vec3& vertexPosition, std::optional<size_t> hintFaceIndex = std::nullopt) const;
 
     bool canPointSeeEdge(const glm::vec3& point, size_t vertexIndex0, size_t vertexIndex1) const;
 
-    size_t addVertex_StreamingTriangulation(const glm::vec3& vertexPosition);
+    // The infinite faces form a ring around the convex hull, linked by their neighbours. Next and previous follow
+    // the order of the faces turning around the infinite vertex, in constant time.
+    Index nextHullFace(size_t faceIndex) const;
+
+    Index previousHullFace(size_t faceIndex) const;
+
+    // Whether the point sees the hull edge of the infinite face from outside of the hull.
+    bool isHullEdgeVisible(size_t faceIndex, const glm::vec3& point) const;
+
+    Index addVertex_StreamingTriangulation(const glm::vec3& vertexPosition);
 
     bool isEdgeDelaunay(const Edge& edge) const;
 
-    int addVertex_StreamingDelaunayTriangulation(const glm::vec3& vertexPosition);
+    bool isEdgeDelaunay(size_t faceIndex, glm::length_t localEdgeIndex) const;
+
+    // Returns the flips count, or for the Bowyer-Watson kernel the count of flips that would have built the same star.
+    int addVertex_StreamingDelaunayTriangulation(const glm::vec3& vertexPosition, InsertionKernel kernel = InsertionKernel::FLIPS);
+
+    // Replaces the mesh by the Delaunay triangulation of the points, built in one go with a sweep-hull algorithm.
+    // Vertex indices follow the input order and the infinite vertex is added last.
+    void buildDelaunay(std::span<const glm::vec3> points);
+
+    // Same as buildDelaunay, but the points are split into vertical strips triangulated on their own thread.
+    // Triangles whose circumcircle stays inside their strip are kept, and the seams are triangulated afterwards.
+    // The output is only guaranteed to be identical to buildDelaunay for points in general position: with four or
+    // more cocircular points, like on a grid, the strips may choose other diagonals. It is still a Delaunay triangulation.
+    void buildDelaunayParallel(std::span<const glm::vec3> points, size_t threadCount = std::thread::hardware_concurrency());
+
+    // Inserts the points in a biased randomized insertion order along a Hilbert curve, while keeping
+    // the Delaunay property. Vertex indices follow the input order. Returns the flips count.
+    int insertPoints(std::span<const glm::vec3> points, InsertionKernel kernel = InsertionKernel::FLIPS);
 
-    int delaunayAlgorithm(std::deque<Edge>& checkList);
+    // Inserts Steiner points at the circumcenters of the worst triangles until every finite triangle has angles of at
+    // least minAngle degrees and an area of at most maxArea. Hull and constrained edges are segments: a segment with a
+    // vertex or a circumcenter inside its diametral circle is split near its middle instead, at a float point exactly on
+    // it. Segments without such a point, short ones or ones along which a coordinate barely changes, are left as they
+    // are, and so are the triangles whose circumcenter encroaches upon them or lies beyond them.
+    // Termination is only guaranteed for minimum angles up to about 20.7 degrees.
+    // Returns the Steiner points count.
+    int refine(float minAngle, float maxArea = std::numeric_limits<float>::infinity(), size_t maxSteinerPoints = 1'000'000);
+
+    // Circumcenters are computed in a parallel pass over the faces, then the cells are gathered from the face indices
+    // around each vertex. Cells of hull vertices are built by clipping the box with the bisectors of their edges.
+    VoronoiDiagram computeVoronoiDiagram(const glm::vec2& boxMin, const glm::vec2& boxMax, size_t threadCount = std::thread::hardware_concurrency()) const;
+
+    // Flips the edges of the stack, and the edges around them, until they are all Delaunay. Returns the flips count.
+    int delaunayAlgorithm(std::vector<Corner>& edgeStack);
 
     int delaunayAlgorithm();
 
@@ -123,15 +296,53 @@ public:
 
     glm::length_t localVertexIndex(size_t globalVertexIndex, size_t faceIndex) const;
 
-    size_t globalVertexIndex(glm::length_t localVertexIndex, size_t faceIndex) const;
+    Index globalVertexIndex(glm::length_t localVertexIndex, size_t faceIndex) const;
+
+    Index firstFaceIndex(size_t vertexIndex) const;
+
+    Index CCWFaceIndex(size_t vertexIndex, size_t faceIndex) const;
+
+    Index CWFaceIndex(size_t vertexIndex, size_t faceIndex) const;
+
+    Index oppositeFaceIndex(size_t vertexIndex, size_t faceIndex) const;
+
+    // Local index, in the neighbour across the edge localEdgeIndex of the face, of the vertex opposite to that edge.
+    glm::length_t oppositeLocalIndex(size_t faceIndex, glm::length_t localEdgeIndex) const;
+
+    // Corner table view of the faces: the corner 3 * f + k is the local vertex k of the face f. The opposite corner
+    // array is not stored, it is read from the neighbours and their 2 bits opposite local indices in constant time.
+    using CornerIndex = Index;
+
+    static inline CornerIndex cornerIndex(size_t faceIndex, glm::length_t localVertexIndex) { return static_cast<CornerIndex>(3 * faceIndex + localVertexIndex); }
 
-    size_t firstFaceIndex(size_t vertexIndex) const;
+    static inline Index cornerFace(CornerIndex corner) { return corner / 3; }
 
-    size_t CCWFaceIndex(size_t vertexIndex, size_t faceIndex) const;
+    static inline glm::length_t cornerLocal(CornerIndex corner) { return static_cast<glm::length_t>(corner % 3); }
 
-    size_t CWFaceIndex(size_t vertexIndex, size_t faceIndex) const;
+    static inline CornerIndex nextCorner(CornerIndex corner) { return corner % 3 == 2 ? corner - 2 : corner + 1; }
 
-    size_t oppositeFaceIndex(size_t vertexIndex, size_t faceIndex) const;
+    static inline CornerIndex previousCorner(CornerIndex corner) { return corner % 3 == 0 ? corner + 2 : corner - 1; }
+
+    inline Index cornerVertex(CornerIndex corner) const { return m_Faces[corner / 3].indices[corner % 3]; }
+
+    // Corner of the neighbour facing the same edge as the corner.
+    inline CornerIndex oppositeCorner(CornerIndex corner) const
+    {
+        const auto& f = m_Faces[corner / 3];
+        return cornerIndex(f.neighbours[corner % 3], f.oppositeLocal(cornerLocal(corner)));
+    }
+
+    // Corner of the vertex in its first face.
+    inline CornerIndex vertexCorner(size_t vertexIndex) const
+    {
+        const Index faceIndex = firstFaceIndex(vertexIndex);
+        return cornerIndex(faceIndex, localVertexIndex(vertexIndex, faceIndex));
+    }
+
+    // Next corner of the same vertex, counter clockwise or clockwise.
+    inline CornerIndex CCWCorner(CornerIndex corner) const { return nextCorner(oppositeCorner(nextCorner(corner))); }
+
+    inline CornerIndex CWCorner(CornerIndex corner) const { return previousCorner(oppositeCorner(previousCorner(corner))); }
 
     void printVertexPosition(size_t vertexIndex) const;
 
@@ -148,13 +359,24 @@ public:
     void loadOFF(const std::string& path);
     void saveOFF(const std::string& path) const;
 
+    // Binary cache of the mesh, with the vertex and face arrays written as they are in memory. The source checksum
+    // identifies the data the mesh was built from. Saving writes a temporary file renamed over the cache. Loading fails
+    // and leaves the mesh untouched if the file is missing, was written with another format version, another index type
+    // or from other data, or if its arrays do not match the checksum stored with them.
+    bool saveBinary(const std::filesystem::path& path, uint64_t sourceChecksum) const;
+    bool loadBinary(const std::filesystem::path& path, uint64_t sourceChecksum);
+
+    // FNV-1a hash of the data. Several pieces of data are hashed together by passing the previous hash as seed.
+    static uint64_t Checksum(std::string_view data, uint64_t seed = 14695981039346656037ull);
+
     vrm::MeshData toMeshData() const;
 
+    // Vertex normals along the Laplacian of the positions, with the weights assembled for the call or precomputed.
     vrm::MeshData toSmoothMeshData() const;
+    vrm::MeshData toSmoothMeshData(const CotanLaplacian& laplacian) const;
 
-    template <typename Fn>
-    vrm::MeshData toHeatMeshData(Fn heatFunction, float factor) const;
-
+    // Laplacian of u at one vertex, with the cotangent weights computed on the fly.
+    // CotanLaplacian precomputes them for the whole mesh when the Laplacian is needed many times.
     template<typename Fn>
     auto laplacian(const size_t vertexIndex, Fn u) const -> typename std::invoke_result<Fn, size_t>::type;
 
@@ -173,8 +395,10 @@ public: // Iterators
         
     public:
         Circulator_on_faces(const TriangularMesh* mesh, size_t vertexIndex, size_t faceIndex, int count = 0)
-            : m_Mesh(mesh), m_VertexIndex(vertexIndex), m_FaceIndex(faceIndex), m_Count(count)
+            : m_Mesh(mesh), m_StartCorner(mesh->vertexCorner(vertexIndex)), m_Corner(m_StartCorner), m_Count(count)
         {
+            if (faceIndex != cornerFace(m_StartCorner))
+                m_Corner = cornerIndex(faceIndex, mesh->localVertexIndex(vertexIndex, faceIndex));
         }
 
         Circulator_on_faces(const Circulator_on_faces& other) = default;
@@ -183,18 +407,30 @@ public: // Iterators
 
         size_t operator*() const
         {
-            return m_FaceIndex;
+            return cornerFace(m_Corner);
         }
 
         size_t operator->() const
         {
-            return m_FaceIndex;
+            return cornerFace(m_Corner);
+        }
+
+        // Local index of the turning vertex in the current face
+        glm::length_t localVertexIndex() const
+        {
+            return cornerLocal(m_Corner);
+        }
+
+        // Corner of the turning vertex in the current face
+        CornerIndex corner() const
+        {
+            return m_Corner;
         }
 
         Circulator_on_faces& operator++()
         {
-            m_FaceIndex = m_Mesh->CCWFaceIndex(m_VertexIndex, m_FaceIndex);
-            if (m_FaceIndex == m_Mesh->firstFaceIndex(m_VertexIndex))
+            m_Corner = m_Mesh->CCWCorner(m_Corner);
+            if (m_Corner == m_StartCorner)
                 m_Count++;
             return *this;
         }
@@ -208,8 +444,8 @@ public: // Iterators
 
         Circulator_on_faces& operator--()
         {
-            m_FaceIndex = m_Mesh->CWFaceIndex(m_VertexIndex, m_FaceIndex);
-            if (m_FaceIndex == m_Mesh->firstFaceIndex(m_VertexIndex))
+            m_Corner = m_Mesh->CWCorner(m_Corner);
+            if (m_Corner == m_StartCorner)
                 m_Count--;
             return *this;
         }
@@ -223,7 +459,7 @@ public: // Iterators
 
         bool operator==(const Circulator_on_faces& other) const
         {
-            return m_VertexIndex == other.m_VertexIndex && m_FaceIndex == other.m_FaceIndex && m_Count == other.m_Count;
+            return m_Corner == other.m_Corner && m_Count == other.m_Count;
         }
 
         bool operator!=(const Circulator_on_faces& other) const
@@ -233,8 +469,9 @@ public: // Iterators
 
     private:
         const TriangularMesh* m_Mesh;
-        size_t m_VertexIndex;
-        size_t m_FaceIndex;
+        // Corner of the vertex in its first face, where the turns are counted
+        CornerIndex m_StartCorner;
+        CornerIndex m_Corner;
         int m_Count = 0;
     };
 
@@ -245,22 +482,18 @@ public: // Iterators
         
     public:
         Circulator_on_vertices(const TriangularMesh* mesh, size_t vertexIndex, int count = 0)
-            : m_Mesh(mesh), m_VertexIndex(vertexIndex), m_Face(mesh, vertexIndex, mesh->firstFaceIndex(vertexIndex), count), m_Count(count)
+            : m_Mesh(mesh), m_Face(mesh, vertexIndex, mesh->firstFaceIndex(vertexIndex), count)
         {
-            m_TurningVertexIndex_local = (m_Mesh->localVertexIndex(m_VertexIndex, *m_Face) + 1) % 3;
         }
 
         size_t operator*() const
         {
-            return m_Mesh->getFace(*m_Face).indices[m_TurningVertexIndex_local];
+            return m_Mesh->cornerVertex(nextCorner(m_Face.corner()));
         }
 
         Circulator_on_vertices& operator++()
         {
             ++m_Face;
-            m_TurningVertexIndex_local = (m_Mesh->localVertexIndex(m_VertexIndex, *m_Face) + 1) % 3;
-            if (*m_Face == m_Mesh->firstFaceIndex(m_VertexIndex))
-                m_Count++;
             return *this;
         }
 
@@ -274,9 +507,6 @@ public: // Iterators
         Circulator_on_vertices& operator--()
         {
             --m_Face;
-            m_TurningVertexIndex_local = (m_Mesh->localVertexIndex(m_VertexIndex, *m_Face) + 1) % 3;
-            if (*m_Face == m_Mesh->firstFaceIndex(m_VertexIndex))
-                m_Count--;
             return *this;
         }
 
@@ -289,7 +519,7 @@ public: // Iterators
 
         bool operator==(const Circulator_on_vertices& other) const
         {
-            return m_VertexIndex == other.m_VertexIndex && *m_Face == *other.m_Face && m_Count == other.m_Count;
+            return m_Face == other.m_Face;
         }
 
         bool operator!=(const Circulator_on_vertices& other) const
@@ -299,10 +529,7 @@ public: // Iterators
 
     private:
         const TriangularMesh* m_Mesh;
-        size_t m_VertexIndex;
         Circulator_on_faces m_Face;
-        glm::length_t m_TurningVertexIndex_local;
-        int m_Count = 0;
     };
 
 public: // Iterator access
@@ -333,14 +560,156 @@ public: // Iterator access
         return Circulator_on_vertices(this, vertexIndex, 1);
     }
 
+private:
+    // Adds a vertex, in the slot of a removed vertex if there is one.
+    Index newVertex(const Vertex& v);
+
+    // Adds an uninitialized face, in the slot of a removed face if there is one.
+    Index newFace();
+
+    // Faces of removed vertices are degenerated on the infinite vertex until their slot is reused.
+    inline bool isFaceFree(size_t faceIndex) const { return m_Faces.at(faceIndex).i0 == m_Faces.at(faceIndex).i1; }
+
+    // Edge around a hole, seen from inside the hole.
+    struct HoleEdge
+    {
+        Index from, to;
+        Corner outside;
+        bool constrained;
+    };
+
+    // Triangulates the counter clockwise polygon (which may contain the infinite vertex) with Delaunay triangles.
+    // The first triangle is built on the first edge of the polygon.
+    void fillHole(const std::vector<Index>& polygon, std::vector<glm::vec<3, Index>>& triangles) const;
+
+    // Writes the triangles in the first faces and links them to each other and to the faces around the hole.
+    void setHoleTriangles(const std::vector<Index>& faces, std::vector<glm::vec<3, Index>>& triangles, const std::vector<HoleEdge>& boundary);
+
+    void setEdgeConstrained(size_t faceIndex, glm::length_t localEdgeIndex, bool constrained);
+
+    inline glm::dvec2 planePosition(size_t vertexIndex) const
+    {
+        const auto& p = m_Vertices.at(vertexIndex).position;
+        return glm::dvec2(p.x, -p.z);
+    }
+
+    // Makes the edge localEdgeIndex0 of the face faceIndex0 and the edge localEdgeIndex1 of the face faceIndex1 neighbours.
+    void linkFaces(size_t faceIndex0, glm::length_t localEdgeIndex0, size_t faceIndex1, glm::length_t localEdgeIndex1);
+
+    // Replaces the mesh by counter clockwise triangles and their opposite half-edges (SweepDelaunay::Invalid on the hull),
+    // closing the hull with infinite faces. The finite faces are filled on threadCount threads.
+    void setTriangulation(std::span<const glm::vec3> points, const std::vector<uint32_t>& triangles, const std::vector<uint32_t>& halfEdges,
+                          size_t threadCount = 1);
+
+    // Level of the Delaunay hierarchy, defined after the class.
+    struct HierarchyLevel;
+
+    static constexpr size_t HierarchyRatio = 30;
+    static constexpr size_t HierarchyMaxLevels = 5;
+
+    // Rebuilds the hierarchy levels from the vertices, if the hierarchy is enabled.
+    void buildHierarchy();
+
+    // Adds levels on top of the hierarchy while the coarsest one is large enough.
+    void growHierarchy();
+
+    // Descends the hierarchy towards the point and returns a face of this mesh close to it.
+    // The faces reached in each level are written in levelFaces, if given.
+    Index descendHierarchy(const glm::vec3& point, std::vector<Index>* levelFaces = nullptr) const;
+
+    // Inserts the vertex in the first levels of the hierarchy, their count being picked at random.
+    void insertInHierarchy(size_t vertexIndex, const std::vector<Index>& levelFaces);
+
+    // Finite vertex of the face which is the closest to the point.
+    Index nearestVertex(size_t faceIndex, const glm::vec3& point) const;
+
+    inline uint32_t nextHierarchyRandom()
+    {
+        m_HierarchyRandom = m_HierarchyRandom * 1664525u + 1013904223u;
+        return m_HierarchyRandom >> 16;
+    }
+
+    // Inserts an already added vertex, locating it from hintFaceIndex. A vertex at the same place as another one is
+    // not inserted and stays free.
+    void insertVertex_StreamingTriangulation(size_t vertexIndex, size_t hintFaceIndex);
+
+    // Whether the point is at a vertex of the finite face, in the plane.
+    bool isPointAtFaceVertex(size_t faceIndex, const glm::vec3& point) const;
+
+    int insertVertex_StreamingDelaunayTriangulation(size_t vertexIndex, size_t hintFaceIndex, InsertionKernel kernel = InsertionKernel::FLIPS);
+
+    // Bowyer-Watson insertion. Falls back on flips when the cavity would cross a constrained edge.
+    int insertVertex_BowyerWatson(size_t vertexIndex, size_t hintFaceIndex);
+
+    // Whether the circumcircle of the face contains the point. For an infinite face, the circle is the open
+    // half-plane beyond its hull edge, with the inside of the edge.
+    bool isInConflict(size_t faceIndex, const glm::vec3& point) const;
+
+    // Flips the edges opposite to the vertex, and the edges around them, until they are all Delaunay. Returns the flips count.
+    int legalizeVertex(size_t vertexIndex);
+
+    // Above 1 when the face has a too small angle (a too large circumradius to shortest edge ratio) or a too large area.
+    double refinementPriority(size_t faceIndex, double maxRadiusEdgeRatio, double maxArea) const;
+
+    // Circumcenter of a finite face, in the plane of planePosition.
+    glm::dvec2 circumcenter(size_t faceIndex) const;
+
+    // Inserts the Steiner point refining the face, its circumcenter or a split point of the segment the circumcenter
+    // encroaches upon, and returns its index. Returns InvalidIndex if there is no point to insert.
+    // The Delaunay property is not restored around the new vertex.
+    Index insertSteinerPoint(size_t faceIndex);
+
+    // Hull edges, between a finite and an infinite face, and constrained edges.
+    bool isSegment(size_t faceIndex, glm::length_t localEdgeIndex) const;
+
+    // Whether the point is strictly inside the diametral circle of the edge.
+    bool isEdgeEncroached(size_t faceIndex, glm::length_t localEdgeIndex, const glm::vec3& point) const;
+
+    // Segment around the faces whose circumcircle contains the point, from the face containing it, which the point
+    // encroaches upon. Those are the segments an insertion of the point would be next to.
+    std::optional<Corner> findEncroachedSegment(size_t faceIndex, const glm::vec3& point);
+
+    // Float point near the middle of the segment, exactly on it in the plane. Such a point may not exist: none is
+    // returned for short segments, nor when the float spacing along the segment has no point on it.
+    std::optional<glm::vec3> segmentSplitPoint(size_t vertexIndex0, size_t vertexIndex1) const;
+
+    // Splits the segment at its split point, and returns the new vertex, or InvalidIndex if it has no split point.
+    Index splitSegment(size_t faceIndex, glm::length_t localEdgeIndex);
+
+    // Starts a new set of faces marked as part of a cavity.
+    void newCavityMark();
+
 private:
     std::vector<Vertex> m_Vertices;
     std::vector<Face> m_Faces;
 
     std::unordered_map<std::pair<size_t, size_t>, std::pair<size_t, glm::length_t>> m_MetEdges;
 
+    std::vector<Index> m_FreeVertices;
+    std::vector<Index> m_FreeFaces;
+
     bool m_IsForTriangulation = false;
-    size_t m_InfiniteVertexIndex = 0;
+    Index m_InfiniteVertexIndex = 0;
+
+    // Scratch buffers of the insertion kernels, kept from one insertion to the next to avoid allocations
+    std::vector<Corner> m_EdgeStack;
+    std::vector<Index> m_CavityFaces;
+    std::vector<HoleEdge> m_CavityBoundary;
+    std::vector<std::pair<Index, Index>> m_CavityStarFaces;
+    std::vector<uint32_t> m_CavityMarks;
+    uint32_t m_CavityMark = 0;
+
+    std::vector<HierarchyLevel> m_HierarchyLevels;
+    bool m_IsHierarchyEnabled = false;
+    uint32_t m_HierarchyRandom = 0;
+};
+
+// Triangulation of a sample of the level below (the mesh itself for the first level),
+// with the index in the level below of each of its vertices.
+struct TriangularMesh::HierarchyLevel
+{
+    TriangularMesh mesh;
+    std::vector<Index> down;
 };
 
 /* Templates implementation */
@@ -359,7 +728,7 @@ auto TriangularMesh::laplacian(const size_t vertexIndex, Fn u) const -> typename
     {
         auto f = *it;
         // Finding vertex j
-        glm::length_t i_local_CCW = localVertexIndex(i, f);
+        glm::length_t i_local_CCW = it.localVertexIndex();
         glm::length_t j_local_CCW = (i_local_CCW + 1) % 3;
         size_t j = globalVertexIndex(j_local_CCW, f);
 
@@ -371,7 +740,7 @@ auto TriangularMesh::laplacian(const size_t vertexIndex, Fn u) const -> typename
         size_t leftFaceIndex = *leftFaceIt;
         size_t& rightFaceIndex = f;
 
-        glm::length_t cwVertexIndex_local = (localVertexIndex(i, leftFaceIndex) + 1) % 3;
+        glm::length_t cwVertexIndex_local = (leftFaceIt.localVertexIndex() + 1) % 3;
         size_t cwVertexIndex = globalVertexIndex(cwVertexIndex_local, leftFaceIndex);
 
         glm::length_t ccwVertexIndex_local = (j_local_CCW + 1) % 3;
@@ -393,60 +762,3 @@ auto TriangularMesh::laplacian(const size_t vertexIndex, Fn u) const -> typename
 
     return laplacian;
 }
-
-template<typename Fn>
-vrm::MeshData TriangularMesh::toHeatMeshData(Fn heatFunction, float factor) const
-{
-    std::vector<vrm::Vertex> vertices;
-    std::vector<uint32_t> indices;
-
-    vertices.resize(getVertexCount());
-    indices.reserve(getFaceCount() * 3);
-
-    auto cores = std::thread::hardware_concurrency();
-
-    auto work = [this, &vertices, &indices, heatFunction, factor](size_t start, size_t end)
-    {
-        for (size_t i = start; i < end; i++)
-        {
-            if (isFaceInfinite(i))
-                continue;
-            
-            Face f = m_Faces.at(m_Vertices.at(i).faceIndex);
-            vrm::Vertex v;
-            v.position = m_Vertices.at(i).position;
-            v.texCoords = { 0.f, 0.f };
-
-            auto positionFunction = [this](size_t i) -> glm::vec3 { return m_Vertices.at(i).position; };
-            v.normal = laplacian(i, positionFunction);
-
-            const glm::vec3 AB = m_Vertices.at(f.i1).position - m_Vertices.at(f.i0).position;
-            const glm::vec3 AC = m_Vertices.at(f.i2).position - m_Vertices.at(f.i0).position;
-            glm::vec3 flatNormal = glm::cross(AB, AC);
-            if (glm::dot(v.normal, flatNormal) < 0.f)
-                v.normal = -v.normal;
-
-            v.scalar = heatFunction(i) + laplacian(i, heatFunction) * factor;
-
-            vertices.at(i) = v;
-        }
-    };
-    
-    std::vector<std::thread> threads;
-    size_t step = getVertexCount() / cores;
-
-    for (size_t i = 0; i < cores; i++)
-        threads.emplace_back(work, i * step, (i == (cores - 1)) ? getVertexCount() : (i + 1) * step);
-
-    for (auto& t : threads)
-        t.join();
-
-    for (const auto& f : m_Faces)
-    {
-        indices.push_back(static_cast<uint32_t>(f.i0));
-        indices.push_back(static_cast<uint32_t>(f.i1));
-        indices.push_back(static_cast<uint32_t>(f.i2));
-    }
-
-    return vrm::MeshData{ std::move(vertices), std::move(indices) };
-}
\ No newline at end of file
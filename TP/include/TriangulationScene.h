@@ -8,6 +8,8 @@
 
 #include <vector>
 #include <filesystem>
+#include <thread>
+#include <functional>
 
 #include "imgui.h"
 #include "TriangularMesh.h"
@@ -34,13 +36,34 @@ private:
 
 	void naiveTriangulation(const std::filesystem::path& data);
 	void delaunayTriangulation(const std::filesystem::path& data);
+	void batchDelaunayTriangulation(const std::filesystem::path& data);
 
-	unsigned long long setupTriangulation(std::ifstream& ifs);
-	void fixHeights(std::ifstream& ifs);
+	// Reads the points of a terrain data file, in file order. Heights are either kept in the points, or stored in heights
+	// with flat points, for the streaming triangulations which insert flat points and fix their heights afterwards.
+	std::vector<glm::vec3> readTerrainPoints(const std::filesystem::path& data, std::vector<float>* heights = nullptr);
+
+	// Loads the triangulation from its binary cache if it was built from the same data, breaklines and settings, otherwise
+	// triangulates and rebuilds the cache. The settings are those the triangulation kind depends on.
+	void triangulateWithCache(const std::filesystem::path& data, const std::string& kind, const std::string& settings, const std::function<void()>& triangulate);
+
+	// Inserts the segments of the .breaklines file next to the terrain data file, if there is one.
+	// Each line of the file holds the indices of two points of the terrain file, after a first line with the segments count.
+	// Returns the number of inserted segments.
+	size_t insertBreaklines(const std::filesystem::path& data, bool infiniteVertexAfterFirstFace);
+
+	// Triangulates every terrain data file and logs the timings.
+	void benchmarkTerrainData();
+
+	// Starts a streaming triangulation with the first three points.
+	void setupTriangulation(std::span<const glm::vec3> points);
+	void fixHeights(const std::vector<float>& heights);
 
 	void resetTriangularMesh();
 	void updateTriangularMesh();
 
+	// Recomputes the Voronoi diagram shown above the terrain, or hides it.
+	void updateVoronoiDiagram();
+
 private:
     vrm::FirstPersonCamera m_Camera;
     float forwardValue = 0.f, rightValue = 0.f, upValue = 0.f;
@@ -56,6 +79,13 @@ private:
 	TriangularMesh m_TriangularMesh;
 	bool m_WireFrame = true;
 	bool m_IntegrityTestWhenUpdating = true;
+	bool m_UseHierarchy = false;
+
+	vrm::MeshAsset m_VoronoiDiagramAsset;
+	bool m_ShowVoronoiDiagram = false;
+
+	std::string m_InsertionKernelLabel = "Flips";
+	TriangularMesh::InsertionKernel m_InsertionKernel = TriangularMesh::InsertionKernel::FLIPS;
 
 	std::string m_TriangulationModeLabel = "Continuous Delaunay";
 	enum class TriangulationMode
@@ -72,6 +102,7 @@ private:
 	{
 		PLACE_VERTICES = 0,
 		FLIP_EDGE,
+		REMOVE_VERTEX,
 	};
 	
 	EditMode m_EditMode = EditMode::PLACE_VERTICES;
@@ -79,6 +110,14 @@ private:
 	std::string m_TerrainDataLabel = "";
 	std::filesystem::path m_TerrainDataPath;
 
+	int m_ThreadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+	bool m_InsertBreaklines = true;
+	bool m_UseTriangulationCache = true;
+
+	float m_RefinementMinAngle = 20.f;
+	float m_RefinementMaxArea = 0.f;
+
 	float m_LastProcessTime = -1.f;
 	int m_LastFlipsCount = -1;
 };
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include "CotanLaplacian.h"
+
+#include <Vroom/Core/Assert.h>
+
+#include <algorithm>
+#include <limits>
+#include <string_view>
+
+namespace
+{
+    // Splits [0, count) in contiguous ranges, one per thread
+    template <typename Fn>
+    void RunOnRanges(size_t count, size_t threadCount, const Fn& work)
+    {
+        if (threadCount <= 1)
+        {
+            work(0, count);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; t++)
+            threads.emplace_back(work, t * count / threadCount, (t + 1) * count / threadCount);
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    // Cotangent of the angle at p in the triangle (p, a, b)
+    inline float Cotangent(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b)
+    {
+        const glm::vec3 pa = a - p;
+        const glm::vec3 pb = b - p;
+        return glm::dot(pa, pb) / glm::length(glm::cross(pa, pb));
+    }
+}
+
+CotanLaplacian::CotanLaplacian(const TriangularMesh& mesh, size_t threadCount)
+{
+    assemble(mesh, threadCount);
+}
+
+void CotanLaplacian::assemble(const TriangularMesh& mesh, size_t threadCount)
+{
+    using CornerIndex = TriangularMesh::CornerIndex;
+
+    const size_t vertexCount = mesh.getVertexCount();
+    threadCount = std::max<size_t>(1, std::min(threadCount, vertexCount / MinRowsPerThread + 1));
+
+    auto hasRow = [&mesh](size_t i) { return !mesh.isVertexFree(i) && !mesh.isVertexInfinite(i); };
+
+    /* Counting the neighbours of each vertex */
+
+    m_RowOffsets.assign(vertexCount + 1, 0);
+    RunOnRanges(vertexCount, threadCount, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (!hasRow(i))
+                continue;
+
+            Index count = 0;
+            for (auto it = mesh.begin_turning_faces(i); it != mesh.end_turning_faces(i); ++it)
+                count += !mesh.isVertexInfinite(mesh.cornerVertex(TriangularMesh::nextCorner(it.corner())));
+
+            m_RowOffsets[i + 1] = count;
+        }
+    });
+
+    for (size_t i = 0; i < vertexCount; i++)
+        m_RowOffsets[i + 1] += m_RowOffsets[i];
+
+    VRM_ASSERT_MSG(m_RowOffsets.back() < std::numeric_limits<Index>::max(), "Too many weights for the index type.");
+
+    /* Weights of each row */
+
+    m_Columns.resize(m_RowOffsets.back());
+    m_Weights.resize(m_RowOffsets.back());
+    m_VertexAreas.assign(vertexCount, 0.f);
+
+    RunOnRanges(vertexCount, threadCount, [&](size_t begin, size_t end)
+    {
+        auto position = [&mesh](CornerIndex corner) -> const glm::vec3& { return mesh.getVertex(mesh.cornerVertex(corner)).position; };
+
+        for (size_t i = begin; i < end; i++)
+        {
+            if (!hasRow(i))
+                continue;
+
+            Index k = m_RowOffsets[i];
+            float sumAreas = 0.f;
+
+            // Edge (i, j) is shared by the current face (i, j, ccw) and the previous one (i, cw, j)
+            for (auto it = mesh.begin_turning_faces(i); it != mesh.end_turning_faces(i); ++it)
+            {
+                const CornerIndex corner = it.corner();
+                const CornerIndex cwCorner = mesh.CWCorner(corner);
+                const Index j = mesh.cornerVertex(TriangularMesh::nextCorner(corner));
+
+                float cotAlpha = 0.f;
+                float cotBeta = 0.f;
+
+                if (!mesh.isFaceInfinite(TriangularMesh::cornerFace(cwCorner)))
+                    cotAlpha = Cotangent(position(TriangularMesh::nextCorner(cwCorner)), position(cwCorner), position(TriangularMesh::previousCorner(cwCorner)));
+
+                if (!mesh.isFaceInfinite(TriangularMesh::cornerFace(corner)))
+                {
+                    const glm::vec3& ccw = position(TriangularMesh::previousCorner(corner));
+                    cotBeta = Cotangent(ccw, position(corner), position(TriangularMesh::nextCorner(corner)));
+                    sumAreas += glm::length(glm::cross(position(corner) - ccw, position(TriangularMesh::nextCorner(corner)) - ccw)) / 2.f;
+                }
+
+                if (mesh.isVertexInfinite(j))
+                    continue;
+
+                m_Columns[k] = j;
+                m_Weights[k] = (cotAlpha + cotBeta) / 2.f;
+                k++;
+            }
+
+            m_VertexAreas[i] = sumAreas / 3.f;
+        }
+    });
+
+    auto bytes = [](const auto& values) { return std::string_view(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(values[0])); };
+
+    m_PatternChecksum = TriangularMesh::Checksum(bytes(m_Columns), TriangularMesh::Checksum(bytes(m_RowOffsets)));
+    m_ValuesChecksum = TriangularMesh::Checksum(bytes(m_VertexAreas), TriangularMesh::Checksum(bytes(m_Weights), m_PatternChecksum));
+}
+
+std::vector<bool> CotanLaplacian::getFixedMask(std::span<const Index> fixedVertices) const
+{
+    std::vector<bool> isFixed(getVertexCount(), false);
+    for (const Index v : fixedVertices)
+        isFixed.at(v) = true;
+    for (size_t i = 0; i < isFixed.size(); i++)
+        isFixed[i] = isFixed[i] || !(m_VertexAreas[i] > 0.f);
+
+    return isFixed;
+}
+
+void CotanLaplacian::apply(std::span<const float> field, std::span<float> result, size_t threadCount) const
+{
+    multiply(field, result, threadCount);
+}
+
+void CotanLaplacian::apply(std::span<const glm::vec3> field, std::span<glm::vec3> result, size_t threadCount) const
+{
+    multiply(field, result, threadCount);
+}
+
+size_t CotanLaplacian::diffuse(std::span<const float> heat, float timeStep, std::span<float> result, std::span<const Index> fixedVertices,
+    float tolerance, size_t maxIterations, size_t threadCount) const
+{
+    const size_t n = getVertexCount();
+    VRM_ASSERT_MSG(heat.size() >= n && result.size() >= n, "The heat needs one value per vertex.");
+
+    const std::vector<bool> isFixed = getFixedMask(fixedVertices);
+
+    const Index* offsets = m_RowOffsets.data();
+    const Index* columns = m_Columns.data();
+    const float* weights = m_Weights.data();
+    const float* areas = m_VertexAreas.data();
+    const double t = timeStep;
+
+    // Ax = Mx - tLx, with the sums in double so that the solver converges below the float precision
+    auto multiplySystem = [&](const std::vector<double>& x, std::vector<double>& ax)
+    {
+        runOnRows(threadCount, [&](size_t rowBegin, size_t rowEnd)
+        {
+            for (size_t i = rowBegin; i < rowEnd; i++)
+            {
+                double sum = 0.0;
+                for (Index k = offsets[i]; k < offsets[i + 1]; k++)
+                    sum += weights[k] * (x[columns[k]] - x[i]);
+
+                ax[i] = areas[i] * x[i] - t * sum;
+            }
+        });
+    };
+
+    auto dot = [n](const std::vector<double>& a, const std::vector<double>& b)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; i++)
+            sum += a[i] * b[i];
+        return sum;
+    };
+
+    // Diagonal of the system, as Jacobi preconditioner
+    std::vector<double> inverseDiagonal(n, 0.0);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (isFixed[i])
+            continue;
+
+        double sum = 0.0;
+        for (Index k = offsets[i]; k < offsets[i + 1]; k++)
+            sum += weights[k];
+
+        inverseDiagonal[i] = 1.0 / (areas[i] + t * sum);
+    }
+
+    // Warm start from the guess, with the fixed heats. Their residuals and directions stay at zero, so that the
+    // solver only works on the symmetric system of the free vertices.
+    std::vector<double> x(n), b(n), r(n), z(n), p(n), q(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        x[i] = isFixed[i] ? heat[i] : result[i];
+        b[i] = areas[i] * static_cast<double>(heat[i]);
+    }
+
+    multiplySystem(x, q);
+
+    double normB = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        r[i] = isFixed[i] ? 0.0 : b[i] - q[i];
+        z[i] = r[i] * inverseDiagonal[i];
+        p[i] = z[i];
+        normB += b[i] * b[i];
+    }
+
+    const double threshold = tolerance * tolerance * std::max(normB, std::numeric_limits<double>::min());
+    double rz = dot(r, z);
+
+    size_t iteration = 0;
+    for (; iteration < maxIterations && dot(r, r) > threshold; iteration++)
+    {
+        multiplySystem(p, q);
+        const double alpha = rz / dot(p, q);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] += alpha * p[i];
+            r[i] -= isFixed[i] ? 0.0 : alpha * q[i];
+            z[i] = r[i] * inverseDiagonal[i];
+        }
+
+        const double rzNext = dot(r, z);
+        const double beta = rzNext / rz;
+        rz = rzNext;
+
+        for (size_t i = 0; i < n; i++)
+            p[i] = z[i] + beta * p[i];
+    }
+
+    for (size_t i = 0; i < n; i++)
+        result[i] = static_cast<float>(x[i]);
+
+    return iteration;
+}
+
+template <typename Fn>
+void CotanLaplacian::runOnRows(size_t threadCount, const Fn& work) const
+{
+    const size_t rowCount = getVertexCount();
+    threadCount = std::max<size_t>(1, std::min(threadCount, rowCount / MinRowsPerThread + 1));
+
+    if (threadCount == 1)
+    {
+        work(0, rowCount);
+        return;
+    }
+
+    // Rows are split on the weights count, since the valences vary
+    std::vector<size_t> bounds(threadCount + 1, rowCount);
+    bounds[0] = 0;
+    for (size_t t = 1; t < threadCount; t++)
+        bounds[t] = std::lower_bound(m_RowOffsets.begin(), m_RowOffsets.end() - 1, t * m_Weights.size() / threadCount) - m_RowOffsets.begin();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++)
+        threads.emplace_back(work, bounds[t], bounds[t + 1]);
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+template <typename T>
+void CotanLaplacian::multiply(std::span<const T> field, std::span<T> result, size_t threadCount) const
+{
+    const size_t rowCount = getVertexCount();
+    VRM_ASSERT_MSG(field.size() >= rowCount && result.size() >= rowCount, "The field needs one value per vertex.");
+
+    // Raw pointers keep the bound checks out of the inner loop, which is a gather of a few neighbours
+    const Index* offsets = m_RowOffsets.data();
+    const Index* columns = m_Columns.data();
+    const float* weights = m_Weights.data();
+    const float* areas = m_VertexAreas.data();
+    const T* u = field.data();
+    T* laplacian = result.data();
+
+    runOnRows(threadCount, [=](size_t rowBegin, size_t rowEnd)
+    {
+        for (size_t i = rowBegin; i < rowEnd; i++)
+        {
+            const T ui = u[i];
+            T sum = T(0.f);
+
+            for (Index k = offsets[i]; k < offsets[i + 1]; k++)
+                sum += weights[k] * (u[columns[k]] - ui);
+
+            laplacian[i] = areas[i] > 0.f ? sum / areas[i] : T(0.f);
+        }
+    });
+}
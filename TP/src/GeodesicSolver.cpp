@@ -0,0 +1,234 @@
+#include "GeodesicSolver.h"
+
+#include <Vroom/Core/Assert.h>
+
+#include <limits>
+#include <algorithm>
+
+GeodesicSolver::GeodesicSolver(const TriangularMesh& mesh, float timeFactor)
+{
+    build(mesh, timeFactor);
+}
+
+void GeodesicSolver::build(const TriangularMesh& mesh, float timeFactor)
+{
+    m_Laplacian.assemble(mesh);
+
+    /* Operators on the faces */
+
+    m_Faces.clear();
+    m_CornerGradients.clear();
+    m_CornerDivergences.clear();
+
+    double sumEdgeLengths = 0.0;
+
+    for (size_t f = 0; f < mesh.getFaceCount(); f++)
+    {
+        const auto& indices = mesh.getFace(f).indices;
+        if (mesh.isFaceInfinite(f) || indices[0] == indices[1])
+            continue;
+
+        const glm::vec3 p[3] = { mesh.getVertex(indices[0]).position, mesh.getVertex(indices[1]).position, mesh.getVertex(indices[2]).position };
+        const glm::vec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+        const float doubleArea = glm::length(normal);
+
+        if (!(doubleArea > 0.f))
+            continue;
+
+        m_Faces.push_back(indices);
+
+        for (glm::length_t i = 0; i < 3; i++)
+        {
+            const glm::vec3& pi = p[i];
+            const glm::vec3& pj = p[(i + 1) % 3];
+            const glm::vec3& pk = p[(i + 2) % 3];
+
+            // The opposite edge turned a quarter inside the face, over the height
+            m_CornerGradients.push_back(glm::cross(normal / doubleArea, pk - pj) / doubleArea);
+
+            // Each edge from the corner is weighted by the cotangent of its opposite angle
+            const float cotJ = glm::dot(pi - pj, pk - pj) / doubleArea;
+            const float cotK = glm::dot(pi - pk, pj - pk) / doubleArea;
+            m_CornerDivergences.push_back(0.5f * (cotK * (pj - pi) + cotJ * (pk - pi)));
+
+            sumEdgeLengths += glm::length(pj - pi);
+        }
+    }
+
+    /* Connected parts, each one needs a fixed vertex for the Poisson equation to have a single solution */
+
+    const auto offsets = m_Laplacian.getRowOffsets();
+    const auto columns = m_Laplacian.getColumns();
+    const size_t n = m_Laplacian.getVertexCount();
+
+    m_Parts.assign(n, TriangularMesh::InvalidIndex);
+    m_PartCount = 0;
+
+    std::vector<Index> fixedVertices;
+    std::vector<Index> queue;
+
+    for (Index v = 0; v < n; v++)
+    {
+        if (m_Parts[v] != TriangularMesh::InvalidIndex || !(m_Laplacian.getVertexArea(v) > 0.f))
+            continue;
+
+        const Index part = static_cast<Index>(m_PartCount++);
+        fixedVertices.push_back(v);
+
+        queue.assign(1, v);
+        m_Parts[v] = part;
+
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            for (Index k = offsets[queue[head]]; k < offsets[queue[head] + 1]; k++)
+            {
+                const Index w = columns[k];
+                if (m_Parts[w] != TriangularMesh::InvalidIndex || !(m_Laplacian.getVertexArea(w) > 0.f))
+                    continue;
+
+                m_Parts[w] = part;
+                queue.push_back(w);
+            }
+        }
+    }
+
+    /* Heat flow during t = h^2, and Poisson equation -L phi = -div X */
+
+    const double meanEdgeLength = m_Faces.empty() ? 0.0 : sumEdgeLengths / (3.0 * m_Faces.size());
+    const float timeStep = static_cast<float>(timeFactor * meanEdgeLength * meanEdgeLength);
+
+    m_Heat.factorize(m_Laplacian, timeStep);
+    m_Poisson.factorize(m_Laplacian, 1.f, fixedVertices, 0.f);
+}
+
+void GeodesicSolver::computeDistances(std::span<const Index> sources, std::span<float> distances) const
+{
+    const size_t n = getVertexCount();
+    VRM_ASSERT_MSG(distances.size() >= n, "The distances need one value per vertex.");
+
+    /* Heat flow from the sources, far too small for floats far from them */
+
+    std::vector<double> heat(n, 0.0);
+    for (const Index s : sources)
+        heat.at(s) = 1.0;
+
+    m_Heat.diffuse(heat, heat);
+
+    /* Integrated divergence of the normalized gradient, which points away from the sources */
+
+    std::vector<double> divergence(n, 0.0);
+
+    for (size_t f = 0; f < m_Faces.size(); f++)
+    {
+        const auto& indices = m_Faces[f];
+        const glm::dvec3 gradient = heat[indices[0]] * glm::dvec3(m_CornerGradients[3 * f]) + heat[indices[1]] * glm::dvec3(m_CornerGradients[3 * f + 1])
+            + heat[indices[2]] * glm::dvec3(m_CornerGradients[3 * f + 2]);
+
+        const double length = glm::length(gradient);
+        if (!(length > 0.0))
+            continue;
+
+        const glm::dvec3 direction = -gradient / length;
+        for (glm::length_t i = 0; i < 3; i++)
+            divergence[indices[i]] -= glm::dot(glm::dvec3(m_CornerDivergences[3 * f + i]), direction);
+    }
+
+    /* Distances whose gradient is the closest to the directions */
+
+    const std::vector<double> zeros(n, 0.0);
+    std::vector<double> potential(n);
+    m_Poisson.solve(divergence, zeros, potential);
+
+    /*
+     * Several sources of a part do not get the same potential, so loads c on them bring them to a common value k of
+     * their part, which is then the zero of the distances: with G the inverse of the Poisson system between the
+     * sources, G c - k = -potential on the sources, and the loads of each part add up to zero so that nothing flows
+     * to its fixed vertex. Each source costs one more solve.
+     */
+
+    std::vector<Index> loaded;
+    for (const Index s : sources)
+        if (m_Parts.at(s) != TriangularMesh::InvalidIndex)
+            loaded.push_back(s);
+
+    std::sort(loaded.begin(), loaded.end());
+    loaded.erase(std::unique(loaded.begin(), loaded.end()), loaded.end());
+
+    // Unknowns c, then k of the parts with a source, in the order of their first source
+    std::vector<size_t> partUnknowns(m_PartCount, 0);
+    std::vector<size_t> partSourceCounts(m_PartCount, 0);
+    size_t unknownCount = loaded.size();
+    for (const Index s : loaded)
+        if (partSourceCounts[m_Parts[s]]++ == 0)
+            partUnknowns[m_Parts[s]] = unknownCount++;
+
+    std::vector<double> system(unknownCount * (unknownCount + 1), 0.0);
+    auto at = [&system, unknownCount](size_t row, size_t column) -> double& { return system[row * (unknownCount + 1) + column]; };
+
+    std::vector<double> load(n, 0.0);
+    std::vector<double> response(n);
+
+    for (size_t j = 0; j < loaded.size(); j++)
+    {
+        // Alone in its part, the source gets no load
+        if (partSourceCounts[m_Parts[loaded[j]]] > 1)
+        {
+            load[loaded[j]] = 1.0;
+            m_Poisson.solve(load, zeros, response);
+            load[loaded[j]] = 0.0;
+
+            for (size_t i = 0; i < loaded.size(); i++)
+                at(i, j) = response[loaded[i]];
+        }
+
+        const size_t partRow = partUnknowns[m_Parts[loaded[j]]];
+        at(j, partRow) = -1.0;
+        at(partRow, j) = 1.0;
+        at(j, unknownCount) = -potential[loaded[j]];
+    }
+
+    // Gaussian elimination with partial pivoting, the last column being the right-hand side
+    for (size_t k = 0; k < unknownCount; k++)
+    {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < unknownCount; i++)
+            if (std::abs(at(i, k)) > std::abs(at(pivot, k)))
+                pivot = i;
+
+        for (size_t j = k; j <= unknownCount; j++)
+            std::swap(at(k, j), at(pivot, j));
+
+        for (size_t i = k + 1; i < unknownCount; i++)
+        {
+            const double factor = at(i, k) / at(k, k);
+            for (size_t j = k; j <= unknownCount; j++)
+                at(i, j) -= factor * at(k, j);
+        }
+    }
+
+    std::vector<double> solution(unknownCount);
+    for (size_t k = unknownCount; k-- > 0;)
+    {
+        double value = at(k, unknownCount);
+        for (size_t j = k + 1; j < unknownCount; j++)
+            value -= at(k, j) * solution[j];
+        solution[k] = value / at(k, k);
+    }
+
+    // The loads add to the potential through one more solve
+    for (size_t j = 0; j < loaded.size(); j++)
+        load[loaded[j]] = solution[j];
+
+    if (std::any_of(partSourceCounts.begin(), partSourceCounts.end(), [](size_t count) { return count > 1; }))
+    {
+        m_Poisson.solve(load, zeros, response);
+        for (size_t v = 0; v < n; v++)
+            potential[v] += response[v];
+    }
+
+    for (size_t v = 0; v < n; v++)
+    {
+        const bool isReached = m_Parts[v] != TriangularMesh::InvalidIndex && partUnknowns[m_Parts[v]] != 0;
+        distances[v] = isReached ? static_cast<float>(potential[v] - solution[partUnknowns[m_Parts[v]]]) : std::numeric_limits<float>::infinity();
+    }
+}
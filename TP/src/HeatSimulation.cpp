@@ -0,0 +1,81 @@
+#include "HeatSimulation.h"
+
+#include <Vroom/Core/Assert.h>
+
+#include <algorithm>
+#include <utility>
+
+void HeatSimulation::reset(const CotanLaplacian& laplacian, std::span<const Index> sources, float sourceHeat)
+{
+    m_Laplacian = &laplacian;
+
+    m_Heat.assign(laplacian.getVertexCount(), 0.f);
+    m_NextHeat.assign(laplacian.getVertexCount(), 0.f);
+
+    setSources(sources, sourceHeat);
+}
+
+void HeatSimulation::setSources(std::span<const Index> sources, float sourceHeat)
+{
+    m_Sources.assign(sources.begin(), sources.end());
+    m_SourceHeat = sourceHeat;
+
+    applySources();
+}
+
+void HeatSimulation::stepExplicit(float timeStep, size_t iterations)
+{
+    VRM_ASSERT_MSG(m_Laplacian, "The simulation has not been reset with a Laplacian.");
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        m_Laplacian->apply(m_Heat, m_NextHeat);
+
+        for (size_t v = 0; v < m_Heat.size(); v++)
+            m_NextHeat[v] = m_Heat[v] + timeStep * m_NextHeat[v];
+
+        std::swap(m_Heat, m_NextHeat);
+        applySources();
+    }
+}
+
+size_t HeatSimulation::stepConjugateGradient(float timeStep)
+{
+    VRM_ASSERT_MSG(m_Laplacian, "The simulation has not been reset with a Laplacian.");
+
+    // The heat changes little from one step to the next, so it is the starting guess
+    std::copy(m_Heat.begin(), m_Heat.end(), m_NextHeat.begin());
+    const size_t iterations = m_Laplacian->diffuse(m_Heat, timeStep, m_NextHeat, m_Sources);
+
+    std::swap(m_Heat, m_NextHeat);
+    return iterations;
+}
+
+void HeatSimulation::stepCholesky(float timeStep)
+{
+    VRM_ASSERT_MSG(m_Laplacian, "The simulation has not been reset with a Laplacian.");
+
+    m_Cholesky.factorize(*m_Laplacian, timeStep, m_Sources);
+    m_Cholesky.diffuse(m_Heat, m_NextHeat);
+
+    std::swap(m_Heat, m_NextHeat);
+}
+
+bool HeatSimulation::isCholeskyFactorized(float timeStep) const
+{
+    return m_Laplacian && m_Cholesky.isFactorized(*m_Laplacian, timeStep, m_Sources);
+}
+
+void HeatSimulation::copyHeatTo(std::span<vrm::Vertex> vertices) const
+{
+    VRM_ASSERT_MSG(vertices.size() >= m_Heat.size(), "The heat needs one vertex per value.");
+
+    for (size_t v = 0; v < m_Heat.size(); v++)
+        vertices[v].scalar = m_Heat[v];
+}
+
+void HeatSimulation::applySources()
+{
+    for (const Index s : m_Sources)
+        m_Heat.at(s) = m_SourceHeat;
+}
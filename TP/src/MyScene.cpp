@@ -13,6 +13,9 @@
 
 #include <glm/gtx/string_cast.hpp>
 
+#include <limits>
+#include <algorithm>
+
 #include "imgui.h"
 
 MyScene::MyScene()
@@ -62,6 +65,8 @@ void MyScene::onInit()
     /* Processing */
 
     m_TriangularMesh.loadOFF("Resources/OffFiles/queen.off");
+    m_CotanLaplacian.assemble(m_TriangularMesh);
+    m_SmoothMeshData = m_TriangularMesh.toSmoothMeshData(m_CotanLaplacian);
 
     /* Visualization */
 
@@ -149,6 +154,14 @@ void MyScene::onImGui()
             if (ImGui::Selectable("Heat diffusion"))
             {
                 m_ViewMode = "Heat diffusion";
+                if (m_SimulationStarted)
+                    showHeatMesh();
+            }
+
+            if (ImGui::Selectable("Geodesic distance"))
+            {
+                m_ViewMode = "Geodesic distance";
+                showGeodesicDistance();
             }
 
             ImGui::EndCombo();
@@ -157,10 +170,40 @@ void MyScene::onImGui()
         {
             ImGui::TextWrapped("Heat source triangle");
             ImGui::SliderInt("##Heat source triangle", &m_TriangleHeatSource, 0, static_cast<int>(m_TriangularMesh.getVertexCount() - 1));
+            m_IsEditingHeatSystem = ImGui::IsItemActive();
             ImGui::TextWrapped("Heat source value");
             ImGui::SliderFloat("##Heat source value", &m_HeatSourceValue, 0.f, 100.f, "%.0f", ImGuiSliderFlags_Logarithmic);
-            ImGui::TextWrapped("Iterations per frame");
-            ImGui::SliderInt("##Iterations per frame", &m_IterationsPerFrame, 1, 50);
+            if (ImGui::BeginCombo("Heat solver", m_HeatSolver.c_str()))
+            {
+                if (ImGui::Selectable("Explicit"))
+                    m_HeatSolver = "Explicit";
+
+                if (ImGui::Selectable("Conjugate gradient"))
+                    m_HeatSolver = "Conjugate gradient";
+
+                if (ImGui::Selectable("Cholesky"))
+                    m_HeatSolver = "Cholesky";
+
+                ImGui::EndCombo();
+            }
+
+            if (m_HeatSolver == "Explicit")
+            {
+                ImGui::TextWrapped("Iterations per frame");
+                ImGui::SliderInt("##Iterations per frame", &m_IterationsPerFrame, 1, 50);
+            }
+            else
+            {
+                // Implicit steps are stable whatever their size
+                ImGui::TextWrapped("Time step per frame");
+                ImGui::SliderFloat("##Time step per frame", &m_HeatTimeStep, 0.0000001f, 0.01f, "%.7f", ImGuiSliderFlags_Logarithmic);
+                m_IsEditingHeatSystem = m_IsEditingHeatSystem || ImGui::IsItemActive();
+
+                if (m_HeatSolver == "Cholesky")
+                    ImGui::TextWrapped("Factor size: %zu", m_HeatSimulation.getFactorSize());
+                else
+                    ImGui::TextWrapped("Solver iterations: %d", m_LastSolverIterations);
+            }
             
             if (m_SimulationStarted)
             {
@@ -173,6 +216,25 @@ void MyScene::onImGui()
                     showHeatDiffusion();
             }
         }
+        if (m_ViewMode == "Geodesic distance")
+        {
+            // Each query reuses the factorizations, so the distances follow the slider
+            ImGui::TextWrapped("Source vertex");
+            if (ImGui::SliderInt("##Source vertex", &m_GeodesicSource, 0, static_cast<int>(m_TriangularMesh.getVertexCount() - 1)))
+                updateGeodesicDistance();
+
+            if (ImGui::Button("Add source"))
+                m_GeodesicSources.push_back(static_cast<TriangularMesh::Index>(m_GeodesicSource));
+
+            ImGui::SameLine();
+            if (ImGui::Button("Clear sources"))
+            {
+                m_GeodesicSources.clear();
+                updateGeodesicDistance();
+            }
+
+            ImGui::TextWrapped("Sources: %zu", m_GeodesicSources.size() + 1);
+        }
     ImGui::End();
 
     ImGui::Begin("Stats");
@@ -214,7 +276,7 @@ void MyScene::showLaplacianSmooth()
     m_MeshAsset.clear();
 
     std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
-    m_MeshAsset.addSubmesh(m_TriangularMesh.toSmoothMeshData());
+    m_MeshAsset.addSubmesh(m_TriangularMesh.toSmoothMeshData(m_CotanLaplacian));
     std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
     m_LastComputeTimeSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1'000'000.f;
 
@@ -234,7 +296,7 @@ void MyScene::showCurvature()
     m_MeshAsset.clear();
 
     std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
-    m_MeshAsset.addSubmesh(m_TriangularMesh.toSmoothMeshData());
+    m_MeshAsset.addSubmesh(m_TriangularMesh.toSmoothMeshData(m_CotanLaplacian));
     std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
     m_LastComputeTimeSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1'000'000.f;
 
@@ -248,46 +310,105 @@ void MyScene::showCurvature()
 
 void MyScene::showHeatDiffusion()
 {
-    m_SmoothMeshData = m_TriangularMesh.toSmoothMeshData();
-
-    for (glm::length_t i = 0; i < 3; i++)
-    {
-        auto vertexIndex = m_TriangularMesh.getFace(static_cast<size_t>(m_TriangleHeatSource)).indices[i];
-        m_SmoothMeshData.getVertices().at(vertexIndex).scalar = m_HeatSourceValue;
-    }
+    const auto& source = m_TriangularMesh.getFace(static_cast<size_t>(m_TriangleHeatSource)).indices;
+    const TriangularMesh::Index sources[] = { source[0], source[1], source[2] };
+    m_HeatSimulation.reset(m_CotanLaplacian, sources, m_HeatSourceValue);
 
+    showHeatMesh();
     m_SimulationStarted = true;
 }
 
+void MyScene::showHeatMesh()
+{
+    // The mesh is created once per simulation, then each frame only uploads its vertices again
+    m_HeatSimulation.copyHeatTo(m_SmoothMeshData.getVertices());
+
+    if (entityExists("Mesh"))
+        destroyEntity(getEntity("Mesh"));
+
+    m_MeshAsset.clear();
+    m_MeshAsset.addSubmesh(m_SmoothMeshData, vrm::AssetManager::Get().getAsset<vrm::MaterialAsset>("Resources/Material/Mat_Heat.asset"));
+
+    auto entity = createEntity("Mesh");
+    auto& meshComponent = entity.addComponent<vrm::MeshComponent>(m_MeshAsset.createInstance());
+
+    entity.getComponent<vrm::TransformComponent>().setPosition({ 0.f, 0.f, 0.f });
+    entity.getComponent<vrm::TransformComponent>().setScale({ 10.f, 10.f, 10.f });
+}
+
 void MyScene::updateHeatDiffusion(float dt)
 {
-    // Updating heat values
+    // The sources follow the slider
+    const auto& source = m_TriangularMesh.getFace(static_cast<size_t>(m_TriangleHeatSource)).indices;
+    const TriangularMesh::Index sources[] = { source[0], source[1], source[2] };
+    m_HeatSimulation.setSources(sources, m_HeatSourceValue);
 
-    auto heatFunction = [this](size_t vertexIndex) -> float {
-        return m_SmoothMeshData.getVertices().at(vertexIndex).scalar;
-    };
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 
-    for (size_t i = 0; i < static_cast<size_t>(m_IterationsPerFrame); i++)
-    {
-        m_SmoothMeshData = std::move(m_TriangularMesh.toHeatMeshData(heatFunction, 0.0000001f));
+    if (m_HeatSolver == "Explicit")
+        m_HeatSimulation.stepExplicit(0.0000001f, static_cast<size_t>(m_IterationsPerFrame));
+    // The system is factorized again whenever it changes, but not at each frame while a slider changes it
+    else if (m_HeatSolver == "Cholesky" && (!m_IsEditingHeatSystem || m_HeatSimulation.isCholeskyFactorized(m_HeatTimeStep)))
+        m_HeatSimulation.stepCholesky(m_HeatTimeStep);
+    else
+        m_LastSolverIterations = static_cast<int>(m_HeatSimulation.stepConjugateGradient(m_HeatTimeStep));
 
-        for (glm::length_t i = 0; i < 3; i++)
-        {
-            auto vertexIndex = m_TriangularMesh.getFace(static_cast<size_t>(m_TriangleHeatSource)).indices[i];
-            m_SmoothMeshData.getVertices().at(vertexIndex).scalar = m_HeatSourceValue;
-        }
-    }
-    
-    // Updating the mesh
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    m_LastComputeTimeSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1'000'000.f;
+
+    // Only the heat of the render mesh changes
+    m_HeatSimulation.copyHeatTo(m_MeshAsset.getSubmeshData(0).getVertices());
+    m_MeshAsset.updateSubmeshVertices(0);
+}
+
+void MyScene::showGeodesicDistance()
+{
+    // The mesh is created once for the view, then each query only uploads its vertices again
     if (entityExists("Mesh"))
         destroyEntity(getEntity("Mesh"));
 
     m_MeshAsset.clear();
-    m_MeshAsset.addSubmesh(m_SmoothMeshData, vrm::AssetManager::Get().getAsset<vrm::MaterialAsset>("Resources/Material/Mat_Heat.asset"));
+    m_MeshAsset.addSubmesh(m_SmoothMeshData, vrm::AssetManager::Get().getAsset<vrm::MaterialAsset>("Resources/Material/Mat_Geodesic.asset"));
 
     auto entity = createEntity("Mesh");
     auto& meshComponent = entity.addComponent<vrm::MeshComponent>(m_MeshAsset.createInstance());
 
     entity.getComponent<vrm::TransformComponent>().setPosition({ 0.f, 0.f, 0.f });
     entity.getComponent<vrm::TransformComponent>().setScale({ 10.f, 10.f, 10.f });
+
+    updateGeodesicDistance();
+}
+
+void MyScene::updateGeodesicDistance()
+{
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    if (!m_IsGeodesicSolverBuilt)
+    {
+        m_GeodesicSolver.build(m_TriangularMesh);
+        m_IsGeodesicSolverBuilt = true;
+    }
+
+    // The added sources, and the one of the slider
+    std::vector<TriangularMesh::Index> sources = m_GeodesicSources;
+    sources.push_back(static_cast<TriangularMesh::Index>(m_GeodesicSource));
+
+    m_Distances.resize(m_TriangularMesh.getVertexCount());
+    m_GeodesicSolver.computeDistances(sources, m_Distances);
+
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    m_LastComputeTimeSeconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1'000'000.f;
+
+    // Distances in [0, 1] for the shader, vertices out of reach are negative
+    float maxDistance = 0.f;
+    for (const float distance : m_Distances)
+        if (distance != std::numeric_limits<float>::infinity())
+            maxDistance = std::max(maxDistance, distance);
+
+    // Only the distances of the render mesh change
+    auto& vertices = m_MeshAsset.getSubmeshData(0).getVertices();
+    for (size_t v = 0; v < vertices.size(); v++)
+        vertices[v].scalar = m_Distances[v] == std::numeric_limits<float>::infinity() ? -1.f : m_Distances[v] / std::max(maxDistance, 1e-12f);
+
+    m_MeshAsset.updateSubmeshVertices(0);
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Predicates.h"
+
+#include <vector>
+#include <cmath>
+
+namespace
+{
+    // Exact sum of floating point numbers, non overlapping and sorted by increasing magnitude.
+    using Expansion = std::vector<double>;
+
+    void twoSum(double a, double b, double& x, double& y)
+    {
+        x = a + b;
+        const double bVirtual = x - a;
+        const double aVirtual = x - bVirtual;
+        y = (a - aVirtual) + (b - bVirtual);
+    }
+
+    void twoProduct(double a, double b, double& x, double& y)
+    {
+        x = a * b;
+        y = std::fma(a, b, -x);
+    }
+
+    Expansion grow(const Expansion& e, double b)
+    {
+        Expansion h;
+        h.reserve(e.size() + 1);
+
+        double q = b;
+        for (double component : e)
+        {
+            double error;
+            twoSum(q, component, q, error);
+            if (error != 0.0)
+                h.push_back(error);
+        }
+
+        if (q != 0.0 || h.empty())
+            h.push_back(q);
+
+        return h;
+    }
+
+    Expansion sum(Expansion e, const Expansion& f)
+    {
+        for (double component : f)
+            e = grow(e, component);
+        return e;
+    }
+
+    Expansion scale(const Expansion& e, double b)
+    {
+        Expansion h = { 0.0 };
+        for (double component : e)
+        {
+            double x, y;
+            twoProduct(component, b, x, y);
+            h = grow(grow(h, y), x);
+        }
+        return h;
+    }
+
+    Expansion product(const Expansion& e, const Expansion& f)
+    {
+        Expansion h = { 0.0 };
+        for (double component : f)
+            h = sum(h, scale(e, component));
+        return h;
+    }
+
+    Expansion difference(double a, double b)
+    {
+        double x, y;
+        twoSum(a, -b, x, y);
+        return y != 0.0 ? Expansion{ y, x } : Expansion{ x };
+    }
+
+    Expansion negate(Expansion e)
+    {
+        for (double& component : e)
+            component = -component;
+        return e;
+    }
+
+    // The largest component has the sign of the whole expansion
+    double estimate(const Expansion& e)
+    {
+        return e.back();
+    }
+}
+
+double Predicates::Orient2DExact(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c)
+{
+    const Expansion acx = difference(a.x, c.x), acy = difference(a.y, c.y);
+    const Expansion bcx = difference(b.x, c.x), bcy = difference(b.y, c.y);
+
+    return estimate(sum(product(acx, bcy), negate(product(acy, bcx))));
+}
+
+double Predicates::InCircleExact(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c, const glm::dvec2& d)
+{
+    const Expansion adx = difference(a.x, d.x), ady = difference(a.y, d.y);
+    const Expansion bdx = difference(b.x, d.x), bdy = difference(b.y, d.y);
+    const Expansion cdx = difference(c.x, d.x), cdy = difference(c.y, d.y);
+
+    const Expansion aLift = sum(product(adx, adx), product(ady, ady));
+    const Expansion bLift = sum(product(bdx, bdx), product(bdy, bdy));
+    const Expansion cLift = sum(product(cdx, cdx), product(cdy, cdy));
+
+    const Expansion bc = sum(product(bdx, cdy), negate(product(cdx, bdy)));
+    const Expansion ca = sum(product(cdx, ady), negate(product(adx, cdy)));
+    const Expansion ab = sum(product(adx, bdy), negate(product(bdx, ady)));
+
+    return estimate(sum(sum(product(aLift, bc), product(bLift, ca)), product(cLift, ab)));
+}
@@ -0,0 +1,392 @@
+#include "SparseCholesky.h"
+
+#include <Vroom/Core/Assert.h>
+
+#include <algorithm>
+#include <string_view>
+
+namespace
+{
+    // Key of the fixed vertices, whatever their order
+    uint64_t FixedVerticesChecksum(std::span<const SparseCholesky::Index> fixedVertices, uint64_t seed)
+    {
+        std::vector<SparseCholesky::Index> sorted(fixedVertices.begin(), fixedVertices.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        return TriangularMesh::Checksum(std::string_view(reinterpret_cast<const char*>(sorted.data()), sorted.size() * sizeof(sorted[0])), seed);
+    }
+}
+
+bool SparseCholesky::factorize(const CotanLaplacian& laplacian, float timeStep, std::span<const Index> fixedVertices, float massFactor)
+{
+    if (isFactorized(laplacian, timeStep, fixedVertices, massFactor))
+        return false;
+
+    const uint64_t patternKey = FixedVerticesChecksum(fixedVertices, laplacian.getPatternChecksum());
+
+    std::vector<bool> isFixed = laplacian.getFixedMask(fixedVertices);
+
+    // The ordering and the pattern of L only depend on the graph of the free vertices
+    if (!m_HasPattern || patternKey != m_PatternKey || isFixed != m_IsFixed)
+    {
+        m_IsFixed = std::move(isFixed);
+        computeOrdering(laplacian);
+        computeSymbolicFactorization(laplacian);
+
+        m_PatternKey = patternKey;
+        m_HasPattern = true;
+    }
+
+    computeNumericFactorization(laplacian, timeStep, massFactor);
+
+    m_ValuesKey = laplacian.getValuesChecksum();
+    m_TimeStep = timeStep;
+    m_MassFactor = massFactor;
+    m_HasValues = true;
+
+    return true;
+}
+
+bool SparseCholesky::isFactorized(const CotanLaplacian& laplacian, float timeStep, std::span<const Index> fixedVertices, float massFactor) const
+{
+    return m_HasValues && m_TimeStep == timeStep && m_MassFactor == massFactor && m_ValuesKey == laplacian.getValuesChecksum()
+        && m_PatternKey == FixedVerticesChecksum(fixedVertices, laplacian.getPatternChecksum());
+}
+
+void SparseCholesky::clear()
+{
+    *this = SparseCholesky();
+}
+
+void SparseCholesky::computeOrdering(const CotanLaplacian& laplacian)
+{
+    const auto offsets = laplacian.getRowOffsets();
+    const auto columns = laplacian.getColumns();
+    const size_t n = laplacian.getVertexCount();
+
+    m_Order.clear();
+    m_Rank.assign(n, NoParent);
+
+    // Each vertex belongs to the part being dissected with its label, fixed and ordered vertices have label 0
+    std::vector<Index> label(n, 0);
+    std::vector<Index> level(n, 0);
+    Index labelCount = 1;
+
+    std::vector<Index> nodes;
+    for (Index v = 0; v < n; v++)
+    {
+        if (!m_IsFixed[v])
+        {
+            nodes.push_back(v);
+            label[v] = labelCount;
+        }
+    }
+
+    // Breadth first search inside the part, returns the vertices by increasing level
+    std::vector<Index> queue;
+    auto search = [&](Index source, Index partLabel)
+    {
+        queue.clear();
+        queue.push_back(source);
+        level[source] = 0;
+        label[source] = NoParent;
+
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            const Index v = queue[head];
+            for (Index k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Index w = columns[k];
+                if (label[w] != partLabel)
+                    continue;
+
+                label[w] = NoParent;
+                level[w] = level[v] + 1;
+                queue.push_back(w);
+            }
+        }
+
+        for (const Index v : queue)
+            label[v] = partLabel;
+    };
+
+    auto order = [this](const std::vector<Index>& part, std::vector<Index>& label)
+    {
+        for (const Index v : part)
+        {
+            m_Rank[v] = static_cast<Index>(m_Order.size());
+            m_Order.push_back(v);
+            label[v] = 0;
+        }
+    };
+
+    // The separator is ordered after both halves, so that eliminating a half never fills the other one
+    auto dissect = [&](auto& self, std::vector<Index> part, Index partLabel) -> void
+    {
+        if (part.size() <= MinDissectionSize)
+            return order(part, label);
+
+        // Two searches give a pseudo peripheral vertex, whose level sets are thin
+        search(part.front(), partLabel);
+        search(queue.back(), partLabel);
+
+        std::vector<Index> first, second, separator;
+
+        if (queue.size() < part.size())
+        {
+            // Disconnected part, the reached component and the rest are independent
+            first = queue;
+            for (const Index v : first)
+                label[v] = NoParent;
+            for (const Index v : part)
+                if (label[v] == partLabel)
+                    second.push_back(v);
+        }
+        else
+        {
+            // Smallest level set among the ones which keep both halves balanced enough, the median one otherwise
+            const Index lastLevel = level[queue.back()];
+            std::vector<size_t> levelStarts(lastLevel + 2, queue.size());
+            for (size_t q = queue.size(); q-- > 0;)
+                levelStarts[level[queue[q]]] = q;
+
+            Index middle = level[queue[queue.size() / 2]];
+            middle = middle < lastLevel ? middle : 0;
+            for (Index l = 1; l < lastLevel; l++)
+            {
+                const bool isBalanced = 3 * levelStarts[l] >= part.size() && 3 * levelStarts[l + 1] <= 2 * part.size();
+                if (isBalanced && (middle == 0 || levelStarts[l + 1] - levelStarts[l] < levelStarts[middle + 1] - levelStarts[middle]))
+                    middle = l;
+            }
+
+            if (middle == 0)
+                return order(part, label);
+
+            // Vertices of the middle level which only touch the first half do not separate anything
+            auto touchesSecond = [&](Index v)
+            {
+                for (Index k = offsets[v]; k < offsets[v + 1]; k++)
+                    if (label[columns[k]] == partLabel && level[columns[k]] > middle)
+                        return true;
+                return false;
+            };
+
+            for (const Index v : queue)
+                (level[v] < middle || (level[v] == middle && !touchesSecond(v)) ? first : level[v] == middle ? separator : second).push_back(v);
+        }
+
+        const Index firstLabel = ++labelCount;
+        const Index secondLabel = ++labelCount;
+        for (const Index v : first)
+            label[v] = firstLabel;
+        for (const Index v : second)
+            label[v] = secondLabel;
+        for (const Index v : separator)
+            label[v] = 0;
+
+        self(self, std::move(first), firstLabel);
+        self(self, std::move(second), secondLabel);
+        order(separator, label);
+    };
+
+    dissect(dissect, std::move(nodes), labelCount);
+}
+
+void SparseCholesky::computeSymbolicFactorization(const CotanLaplacian& laplacian)
+{
+    const auto offsets = laplacian.getRowOffsets();
+    const auto columns = laplacian.getColumns();
+    const size_t n = m_Order.size();
+
+    m_Parent.assign(n, NoParent);
+    std::vector<Index> flag(n);
+    std::vector<size_t> counts(n, 0);
+
+    // Row k of L has a non zero on each column met from the row entries of A up to the root of the elimination tree
+    for (Index k = 0; k < n; k++)
+    {
+        flag[k] = k;
+        const Index v = m_Order[k];
+
+        for (Index p = offsets[v]; p < offsets[v + 1]; p++)
+        {
+            Index i = m_Rank[columns[p]];
+            if (i == NoParent || i >= k)
+                continue;
+
+            for (; flag[i] != k; i = m_Parent[i])
+            {
+                if (m_Parent[i] == NoParent)
+                    m_Parent[i] = k;
+
+                counts[i]++;
+                flag[i] = k;
+            }
+        }
+    }
+
+    m_FactorOffsets.assign(n + 1, 0);
+    for (size_t k = 0; k < n; k++)
+        m_FactorOffsets[k + 1] = m_FactorOffsets[k] + counts[k];
+
+    m_FactorRows.resize(m_FactorOffsets.back());
+    m_FactorValues.resize(m_FactorOffsets.back());
+}
+
+void SparseCholesky::computeNumericFactorization(const CotanLaplacian& laplacian, float timeStep, float massFactor)
+{
+    const auto offsets = laplacian.getRowOffsets();
+    const auto columns = laplacian.getColumns();
+    const auto weights = laplacian.getWeights();
+    const size_t n = m_Order.size();
+    const double t = timeStep;
+
+    m_Diagonal.assign(n, 0.0);
+    m_Masses.resize(n);
+    m_FixedOffsets.assign(n + 1, 0);
+    m_FixedColumns.clear();
+    m_FixedValues.clear();
+
+    std::vector<double> y(n, 0.0);
+    std::vector<Index> flag(n);
+    std::vector<Index> pattern(n);
+    std::vector<size_t> counts(n, 0);
+
+    for (Index k = 0; k < n; k++)
+    {
+        const Index v = m_Order[k];
+        m_Masses[k] = laplacian.getVertexArea(v);
+
+        // Row k of aM - tL, scattered in y, and its pattern in L in topological order
+        Index top = static_cast<Index>(n);
+        flag[k] = k;
+        y[k] = massFactor * m_Masses[k];
+
+        for (Index p = offsets[v]; p < offsets[v + 1]; p++)
+        {
+            y[k] += t * weights[p];
+
+            Index i = m_Rank[columns[p]];
+            if (i == NoParent)
+            {
+                m_FixedColumns.push_back(columns[p]);
+                m_FixedValues.push_back(t * weights[p]);
+                continue;
+            }
+
+            if (i > k)
+                continue;
+
+            y[i] -= t * weights[p];
+
+            Index length = 0;
+            for (; flag[i] != k; i = m_Parent[i])
+            {
+                pattern[length++] = i;
+                flag[i] = k;
+            }
+
+            while (length > 0)
+                pattern[--top] = pattern[--length];
+        }
+
+        m_FixedOffsets[k + 1] = static_cast<Index>(m_FixedColumns.size());
+
+        // Sparse triangular solve for row k of L, and the pivot
+        m_Diagonal[k] = y[k];
+        y[k] = 0.0;
+
+        for (; top < n; top++)
+        {
+            const Index i = pattern[top];
+            const double yi = y[i];
+            y[i] = 0.0;
+
+            const size_t end = m_FactorOffsets[i] + counts[i];
+            for (size_t p = m_FactorOffsets[i]; p < end; p++)
+                y[m_FactorRows[p]] -= m_FactorValues[p] * yi;
+
+            const double lki = yi / m_Diagonal[i];
+            m_Diagonal[k] -= lki * yi;
+
+            m_FactorRows[end] = k;
+            m_FactorValues[end] = lki;
+            counts[i]++;
+        }
+
+        VRM_ASSERT_MSG(m_Diagonal[k] > 0.0, "The system is not positive definite.");
+    }
+}
+
+void SparseCholesky::diffuse(std::span<const float> heat, std::span<float> result) const
+{
+    diffuseField(heat, result);
+}
+
+void SparseCholesky::diffuse(std::span<const double> heat, std::span<double> result) const
+{
+    diffuseField(heat, result);
+}
+
+void SparseCholesky::solve(std::span<const float> rightHandSide, std::span<const float> fixedValues, std::span<float> result) const
+{
+    solveField(rightHandSide, fixedValues, result);
+}
+
+void SparseCholesky::solve(std::span<const double> rightHandSide, std::span<const double> fixedValues, std::span<double> result) const
+{
+    solveField(rightHandSide, fixedValues, result);
+}
+
+template <typename T>
+void SparseCholesky::diffuseField(std::span<const T> heat, std::span<T> result) const
+{
+    VRM_ASSERT_MSG(m_HasValues, "The system is not factorized.");
+    VRM_ASSERT_MSG(heat.size() >= m_IsFixed.size() && result.size() >= m_IsFixed.size(), "The heat needs one value per vertex.");
+
+    std::vector<double> x(m_Order.size());
+    for (size_t k = 0; k < x.size(); k++)
+        x[k] = m_Masses[k] * heat[m_Order[k]];
+
+    solveOrdered(x, heat, result);
+}
+
+template <typename T>
+void SparseCholesky::solveField(std::span<const T> rightHandSide, std::span<const T> fixedValues, std::span<T> result) const
+{
+    VRM_ASSERT_MSG(m_HasValues, "The system is not factorized.");
+    VRM_ASSERT_MSG(rightHandSide.size() >= m_IsFixed.size() && fixedValues.size() >= m_IsFixed.size() && result.size() >= m_IsFixed.size(),
+        "The right-hand side needs one value per vertex.");
+
+    std::vector<double> x(m_Order.size());
+    for (size_t k = 0; k < x.size(); k++)
+        x[k] = rightHandSide[m_Order[k]];
+
+    solveOrdered(x, fixedValues, result);
+}
+
+template <typename T>
+void SparseCholesky::solveOrdered(std::vector<double>& x, std::span<const T> fixedValues, std::span<T> result) const
+{
+    const size_t n = m_Order.size();
+
+    // The fixed values move to the right-hand side
+    for (size_t k = 0; k < n; k++)
+        for (Index p = m_FixedOffsets[k]; p < m_FixedOffsets[k + 1]; p++)
+            x[k] += m_FixedValues[p] * fixedValues[m_FixedColumns[p]];
+
+    // L D L^T x = b
+    for (size_t j = 0; j < n; j++)
+        for (size_t p = m_FactorOffsets[j]; p < m_FactorOffsets[j + 1]; p++)
+            x[m_FactorRows[p]] -= m_FactorValues[p] * x[j];
+
+    for (size_t j = 0; j < n; j++)
+        x[j] /= m_Diagonal[j];
+
+    for (size_t j = n; j-- > 0;)
+        for (size_t p = m_FactorOffsets[j]; p < m_FactorOffsets[j + 1]; p++)
+            x[j] -= m_FactorValues[p] * x[m_FactorRows[p]];
+
+    for (size_t v = 0; v < m_IsFixed.size(); v++)
+        result[v] = m_IsFixed[v] ? fixedValues[v] : static_cast<T>(x[m_Rank[v]]);
+}
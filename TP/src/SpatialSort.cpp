@@ -0,0 +1,77 @@
+#include "SpatialSort.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <limits>
+
+uint32_t SpatialSort::HilbertIndex(uint32_t x, uint32_t y)
+{
+    constexpr uint32_t n = 1u << 16;
+    uint32_t d = 0;
+
+    for (uint32_t s = n / 2; s > 0; s /= 2)
+    {
+        const uint32_t rx = (x & s) > 0 ? 1 : 0;
+        const uint32_t ry = (y & s) > 0 ? 1 : 0;
+        d += s * s * ((3 * rx) ^ ry);
+
+        // Rotating the quadrant so that the curve stays continuous
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+
+    return d;
+}
+
+std::vector<size_t> SpatialSort::BRIO(std::span<const glm::vec3> points)
+{
+    // Rounds smaller than this are not split anymore
+    constexpr size_t minRoundSize = 64;
+
+    std::vector<size_t> order(points.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    // Fixed seed so that triangulating the same file twice gives the same result
+    std::mt19937 rng(42);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    glm::vec2 min = glm::vec2(std::numeric_limits<float>::max());
+    glm::vec2 max = glm::vec2(std::numeric_limits<float>::lowest());
+
+    for (const auto& p : points)
+    {
+        min = glm::min(min, glm::vec2(p.x, p.z));
+        max = glm::max(max, glm::vec2(p.x, p.z));
+    }
+
+    const glm::vec2 extent = glm::max(max - min, glm::vec2(std::numeric_limits<float>::min()));
+
+    std::vector<uint32_t> keys(points.size());
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        const glm::vec2 normalized = (glm::vec2(points[i].x, points[i].z) - min) / extent;
+        const uint32_t x = static_cast<uint32_t>(glm::clamp(normalized.x, 0.f, 1.f) * 65535.f);
+        const uint32_t y = static_cast<uint32_t>(glm::clamp(normalized.y, 0.f, 1.f) * 65535.f);
+        keys[i] = HilbertIndex(x, y);
+    }
+
+    // Last round holds half of the points, the one before a quarter, and so on
+    for (size_t end = order.size(); end > 0; )
+    {
+        const size_t begin = end > 2 * minRoundSize ? end / 2 : 0;
+
+        std::sort(order.begin() + begin, order.begin() + end, [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+        end = begin;
+    }
+
+    return order;
+}
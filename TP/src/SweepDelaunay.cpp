@@ -0,0 +1,344 @@
+#include "SweepDelaunay.h"
+#include "Predicates.h"
+
+#include <Vroom/Core/Assert.h>
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+
+namespace
+{
+    // Monotonic with the angle of d, in [0, 1], without any trigonometry
+    double pseudoAngle(const glm::dvec2& d)
+    {
+        const double p = d.x / (std::abs(d.x) + std::abs(d.y));
+        return (d.y > 0.0 ? 3.0 - p : 1.0 + p) / 4.0;
+    }
+
+    // Offset of the circumcenter of (a, b, c) from a
+    glm::dvec2 circumcenterOffset(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c)
+    {
+        const glm::dvec2 d = b - a;
+        const glm::dvec2 e = c - a;
+        const double bl = glm::dot(d, d);
+        const double cl = glm::dot(e, e);
+        const double det = 0.5 / (d.x * e.y - d.y * e.x);
+
+        return glm::dvec2((e.y * bl - d.y * cl) * det, (d.x * cl - e.x * bl) * det);
+    }
+
+    double circumradius2(const glm::dvec2& a, const glm::dvec2& b, const glm::dvec2& c)
+    {
+        const glm::dvec2 offset = circumcenterOffset(a, b, c);
+        const double r = glm::dot(offset, offset);
+
+        return std::isfinite(r) ? r : std::numeric_limits<double>::max();
+    }
+}
+
+SweepDelaunay::SweepDelaunay(std::span<const glm::vec3> points)
+{
+    const size_t n = points.size();
+    VRM_ASSERT_MSG(n >= 3, "At least 3 points are needed for a triangulation.");
+
+    m_Coords.reserve(n);
+    for (const auto& p : points)
+        m_Coords.emplace_back(p.x, -p.z);
+
+    /* Seed triangle */
+
+    glm::dvec2 min = m_Coords.front(), max = m_Coords.front();
+    for (const auto& p : m_Coords)
+    {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    const glm::dvec2 boxCenter = (min + max) * 0.5;
+
+    // Point closest to the bounding box center
+    uint32_t i0 = 0;
+    double minDist = std::numeric_limits<double>::max();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        const glm::dvec2 d = m_Coords[i] - boxCenter;
+        if (const double dist = glm::dot(d, d); dist < minDist)
+        {
+            i0 = i;
+            minDist = dist;
+        }
+    }
+
+    // Point closest to the first one
+    uint32_t i1 = Invalid;
+    minDist = std::numeric_limits<double>::max();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        const glm::dvec2 d = m_Coords[i] - m_Coords[i0];
+        if (const double dist = glm::dot(d, d); i != i0 && dist > 0.0 && dist < minDist)
+        {
+            i1 = i;
+            minDist = dist;
+        }
+    }
+    VRM_ASSERT_MSG(i1 != Invalid, "All points are duplicates.");
+
+    // Third point making the smallest circumcircle
+    uint32_t i2 = Invalid;
+    double minRadius = std::numeric_limits<double>::max();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (i == i0 || i == i1)
+            continue;
+
+        if (const double r = circumradius2(m_Coords[i0], m_Coords[i1], m_Coords[i]); r < minRadius)
+        {
+            i2 = i;
+            minRadius = r;
+        }
+    }
+    VRM_ASSERT_MSG(i2 != Invalid, "All points are collinear.");
+
+    if (orient(i0, i1, i2) < 0.0)
+        std::swap(i1, i2);
+
+    m_Center = m_Coords[i0] + circumcenterOffset(m_Coords[i0], m_Coords[i1], m_Coords[i2]);
+
+    // Sorting the points by distance to the seed circumcenter: each point is then outside the current hull
+    std::vector<double> dists(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const glm::dvec2 d = m_Coords[i] - m_Center;
+        dists[i] = glm::dot(d, d);
+    }
+
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&dists](uint32_t a, uint32_t b) { return dists[a] < dists[b]; });
+
+    /* Hull initialization */
+
+    const size_t hashSize = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+
+    m_HullPrev.assign(n, Invalid);
+    m_HullNext.assign(n, Invalid);
+    m_HullTri.assign(n, Invalid);
+    m_HullHash.assign(hashSize, Invalid);
+
+    m_HullStart = i0;
+
+    m_HullNext[i0] = m_HullPrev[i2] = i1;
+    m_HullNext[i1] = m_HullPrev[i0] = i2;
+    m_HullNext[i2] = m_HullPrev[i1] = i0;
+
+    m_HullTri[i0] = 0;
+    m_HullTri[i1] = 1;
+    m_HullTri[i2] = 2;
+
+    m_HullHash[hashKey(m_Coords[i0])] = i0;
+    m_HullHash[hashKey(m_Coords[i1])] = i1;
+    m_HullHash[hashKey(m_Coords[i2])] = i2;
+
+    const size_t maxTriangles = 2 * n - 5;
+    m_Triangles.reserve(maxTriangles * 3);
+    m_HalfEdges.reserve(maxTriangles * 3);
+
+    addTriangle(i0, i1, i2, Invalid, Invalid, Invalid);
+
+    /* Sweep */
+
+    for (size_t k = 0; k < n; k++)
+    {
+        const uint32_t i = order[k];
+
+        if (i == i0 || i == i1 || i == i2)
+            continue;
+
+        // Duplicates are consecutive since they have the same distance
+        if (k > 0 && m_Coords[i] == m_Coords[order[k - 1]])
+        {
+            m_SkippedCount++;
+            continue;
+        }
+
+        // Finding a visible hull edge, starting near the point angle
+        uint32_t start = Invalid;
+        const size_t key = hashKey(m_Coords[i]);
+        for (size_t j = 0; j < hashSize; j++)
+        {
+            start = m_HullHash[(key + j) % hashSize];
+            if (start != Invalid && start != m_HullNext[start])
+                break;
+        }
+
+        start = m_HullPrev[start];
+        uint32_t e = start;
+
+        while (orient(e, m_HullNext[e], i) >= 0.0)
+        {
+            e = m_HullNext[e];
+            if (e == start)
+            {
+                e = Invalid;
+                break;
+            }
+        }
+
+        // Nearly duplicate point: no edge is visible
+        if (e == Invalid)
+        {
+            m_SkippedCount++;
+            continue;
+        }
+
+        // First triangle, on the visible edge
+        uint32_t t = addTriangle(e, i, m_HullNext[e], Invalid, Invalid, m_HullTri[e]);
+        m_HullTri[i] = t + 1;
+        m_HullTri[e] = t;
+        legalize(t + 2);
+
+        // Walking forward on the hull
+        uint32_t next = m_HullNext[e];
+        for (uint32_t q = m_HullNext[next]; orient(next, q, i) < 0.0; q = m_HullNext[next])
+        {
+            t = addTriangle(next, i, q, m_HullTri[i], Invalid, m_HullTri[next]);
+            m_HullTri[i] = t + 1;
+            legalize(t + 2);
+
+            // Marking the vertex as removed from the hull
+            m_HullNext[next] = next;
+            next = q;
+        }
+
+        // Walking backward, only needed if the first visible edge was the starting one
+        if (e == start)
+        {
+            for (uint32_t q = m_HullPrev[e]; orient(q, e, i) < 0.0; q = m_HullPrev[e])
+            {
+                t = addTriangle(q, i, e, Invalid, m_HullTri[e], m_HullTri[q]);
+                m_HullTri[q] = t;
+                legalize(t + 2);
+
+                m_HullNext[e] = e;
+                e = q;
+            }
+        }
+
+        // Updating the hull
+        m_HullStart = m_HullPrev[i] = e;
+        m_HullNext[e] = m_HullPrev[next] = i;
+        m_HullNext[i] = next;
+
+        m_HullHash[hashKey(m_Coords[i])] = i;
+        m_HullHash[hashKey(m_Coords[e])] = e;
+    }
+}
+
+uint32_t SweepDelaunay::addTriangle(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t a, uint32_t b, uint32_t c)
+{
+    const uint32_t t = static_cast<uint32_t>(m_Triangles.size());
+
+    m_Triangles.push_back(i0);
+    m_Triangles.push_back(i1);
+    m_Triangles.push_back(i2);
+
+    m_HalfEdges.push_back(Invalid);
+    m_HalfEdges.push_back(Invalid);
+    m_HalfEdges.push_back(Invalid);
+
+    link(t, a);
+    link(t + 1, b);
+    link(t + 2, c);
+
+    return t;
+}
+
+void SweepDelaunay::link(uint32_t a, uint32_t b)
+{
+    m_HalfEdges[a] = b;
+    if (b != Invalid)
+        m_HalfEdges[b] = a;
+}
+
+/**
+ * Layout:
+ *          pl
+ *        / | \
+ *    al /  |  \ bl
+ *      / a | b \
+ *    p0    |    p1
+ *      \   |   /
+ *    ar \  |  / br
+ *        \ | /
+ *          pr
+ *
+ * a goes from pr to pl, b from pl to pr.
+ */
+void SweepDelaunay::legalize(uint32_t a)
+{
+    m_EdgeStack.clear();
+    m_EdgeStack.push_back(a);
+
+    while (!m_EdgeStack.empty())
+    {
+        a = m_EdgeStack.back();
+        m_EdgeStack.pop_back();
+
+        const uint32_t b = m_HalfEdges[a];
+        if (b == Invalid)
+            continue;
+
+        const uint32_t a0 = a - a % 3;
+        const uint32_t al = a0 + (a + 1) % 3;
+        const uint32_t ar = a0 + (a + 2) % 3;
+
+        const uint32_t b0 = b - b % 3;
+        const uint32_t br = b0 + (b + 1) % 3;
+        const uint32_t bl = b0 + (b + 2) % 3;
+
+        const uint32_t p0 = m_Triangles[ar];
+        const uint32_t pr = m_Triangles[a];
+        const uint32_t pl = m_Triangles[al];
+        const uint32_t p1 = m_Triangles[bl];
+
+        if (!inCircle(p0, pr, pl, p1))
+            continue;
+
+        // Flipping the edge: (pr, pl, p0) and (pl, pr, p1) become (p1, pl, p0) and (p0, pr, p1)
+        m_Triangles[a] = p1;
+        m_Triangles[b] = p0;
+
+        const uint32_t hbl = m_HalfEdges[bl];
+        const uint32_t har = m_HalfEdges[ar];
+
+        link(a, hbl);
+        link(b, har);
+        link(ar, bl);
+
+        // Hull edges may have moved to another half-edge
+        if (hbl == Invalid)
+            m_HullTri[p1] = a;
+        if (har == Invalid)
+            m_HullTri[p0] = b;
+
+        m_EdgeStack.push_back(br);
+        m_EdgeStack.push_back(a);
+    }
+}
+
+size_t SweepDelaunay::hashKey(const glm::dvec2& p) const
+{
+    const size_t hashSize = m_HullHash.size();
+    return static_cast<size_t>(std::floor(pseudoAngle(p - m_Center) * static_cast<double>(hashSize))) % hashSize;
+}
+
+double SweepDelaunay::orient(uint32_t i0, uint32_t i1, uint32_t i2) const
+{
+    return Predicates::Orient2D(m_Coords[i0], m_Coords[i1], m_Coords[i2]);
+}
+
+bool SweepDelaunay::inCircle(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t i3) const
+{
+    return Predicates::InCircle(m_Coords[i0], m_Coords[i1], m_Coords[i2], m_Coords[i3]) > 0.0;
+}
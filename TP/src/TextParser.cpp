@@ -0,0 +1,110 @@
+#include "TextParser.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    m_File = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_File == INVALID_HANDLE_VALUE)
+    {
+        m_File = nullptr;
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_File, &size))
+        return;
+
+    m_Size = static_cast<size_t>(size.QuadPart);
+    m_IsOpen = true;
+
+    // Empty files cannot be mapped
+    if (m_Size == 0)
+        return;
+
+    m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_Mapping)
+        m_Data = static_cast<const char*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (!m_Data)
+    {
+        m_Size = 0;
+        m_IsOpen = false;
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_Data)
+        UnmapViewOfFile(m_Data);
+    if (m_Mapping)
+        CloseHandle(m_Mapping);
+    if (m_File)
+        CloseHandle(m_File);
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return;
+
+    struct stat status;
+    if (fstat(file, &status) == 0)
+    {
+        m_Size = static_cast<size_t>(status.st_size);
+        m_IsOpen = true;
+
+        // Empty files cannot be mapped
+        if (m_Size > 0)
+        {
+            void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                m_Data = static_cast<const char*>(data);
+                madvise(data, m_Size, MADV_SEQUENTIAL);
+            }
+            else
+            {
+                m_Size = 0;
+                m_IsOpen = false;
+            }
+        }
+    }
+
+    // The mapping stays valid without the file descriptor
+    close(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_Data)
+        munmap(const_cast<char*>(m_Data), m_Size);
+}
+
+#endif
+
+std::string_view TextParser::NextLine(std::string_view& text)
+{
+    const size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    return line;
+}
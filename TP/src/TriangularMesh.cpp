@@ -1,8 +1,22 @@
 #include "TriangularMesh.h"
+#include "SpatialSort.h"
+#include "SweepDelaunay.h"
+#include "Predicates.h"
+#include "TextParser.h"
+#include "CotanLaplacian.h"
 
 #include <fstream>
-#include <sstream>
+#include <numeric>
+#include <algorithm>
+#include <tuple>
+#include <limits>
+#include <queue>
 #include <unordered_set>
+#include <cmath>
+#include <atomic>
+#include <array>
+#include <cstring>
+#include <bit>
 
 #include <Vroom/Core/Assert.h>
 
@@ -14,20 +28,26 @@ TriangularMesh::TriangularMesh()
 
 void TriangularMesh::clear()
 {
+    // The hierarchy is a setting of the mesh rather than data
+    const bool isHierarchyEnabled = m_IsHierarchyEnabled;
     *this = TriangularMesh();
+    m_IsHierarchyEnabled = isHierarchyEnabled;
 }
 
-size_t TriangularMesh::addVertex(const Vertex& v)
+TriangularMesh::Index TriangularMesh::addVertex(const Vertex& v)
 {
+    VRM_ASSERT_MSG(m_Vertices.size() < std::numeric_limits<Index>::max(), "Too many vertices for the index type.");
+
     m_Vertices.push_back(v);
     return m_Vertices.size() - 1;
 }
 
-size_t TriangularMesh::addFace(size_t v0, size_t v1, size_t v2)
+TriangularMesh::Index TriangularMesh::addFace(size_t v0, size_t v1, size_t v2)
 {
     VRM_ASSERT(v0 < m_Vertices.size());
     VRM_ASSERT(v1 < m_Vertices.size());
     VRM_ASSERT(v2 < m_Vertices.size());
+    VRM_ASSERT_MSG(m_Faces.size() < std::numeric_limits<Index>::max(), "Too many faces for the index type.");
     
     Face f;
 
@@ -52,8 +72,10 @@ size_t TriangularMesh::addFace(size_t v0, size_t v1, size_t v2)
             glm::length_t& localEdgeIndex = m_MetEdges.at(ei).second;
 
             f.neighbours[i] = globalFaceIndex;
+            f.setOppositeLocal(i, localEdgeIndex);
 
             m_Faces.at(globalFaceIndex).neighbours[localEdgeIndex] = m_Faces.size();
+            m_Faces.at(globalFaceIndex).setOppositeLocal(localEdgeIndex, i);
 
             m_MetEdges.erase(ei);
         }
@@ -68,7 +90,146 @@ size_t TriangularMesh::addFace(size_t v0, size_t v1, size_t v2)
     return m_Faces.size() - 1;
 }
 
-size_t TriangularMesh::addFirstFaceForTriangulation(size_t v0, size_t v1, size_t v2)
+void TriangularMesh::buildAdjacency(size_t threadCount)
+{
+    VRM_ASSERT_MSG(3 * m_Faces.size() < std::numeric_limits<Index>::max(), "Too many faces for the index type.");
+
+    threadCount = std::max<size_t>(1, std::min(threadCount, m_Faces.size() / 1024 + 1));
+    const size_t vertexCount = std::max<size_t>(1, m_Vertices.size());
+    const size_t faceStep = m_Faces.size() / threadCount;
+
+    auto runInParallel = [threadCount](const auto& work)
+    {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; t++)
+            threads.emplace_back(work, t);
+
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    // Half-edge of the corner, with its smallest vertex first so that both twins have the same key
+    struct HalfEdge
+    {
+        Index v0, v1;
+        CornerIndex corner;
+
+        bool operator<(const HalfEdge& other) const { return std::tie(v0, v1, corner) < std::tie(other.v0, other.v1, other.corner); }
+    };
+
+    auto halfEdge = [this](CornerIndex corner)
+    {
+        const auto& f = m_Faces[cornerFace(corner)];
+        const Index a = f.indices[cornerLocal(nextCorner(corner))];
+        const Index b = f.indices[cornerLocal(previousCorner(corner))];
+        return HalfEdge{ std::min(a, b), std::max(a, b), corner };
+    };
+
+    // One bucket per thread, by range of smallest vertex
+    auto bucket = [threadCount, vertexCount](Index v0) { return std::min<size_t>(v0 * threadCount / vertexCount, threadCount - 1); };
+
+    /* Counting the half-edges of each bucket in each chunk of faces */
+
+    std::vector<size_t> offsets(threadCount * threadCount + 1, 0);
+
+    runInParallel([&](size_t t)
+    {
+        const size_t end = (t == threadCount - 1) ? m_Faces.size() : (t + 1) * faceStep;
+        for (size_t i = 3 * t * faceStep; i < 3 * end; i++)
+            offsets[bucket(halfEdge(static_cast<CornerIndex>(i)).v0) * threadCount + t + 1]++;
+    });
+
+    for (size_t k = 1; k < offsets.size(); k++)
+        offsets[k] += offsets[k - 1];
+
+    /* Scattering the half-edges in their bucket */
+
+    std::vector<HalfEdge> halfEdges(3 * m_Faces.size());
+
+    runInParallel([&](size_t t)
+    {
+        std::vector<size_t> cursors(threadCount);
+        for (size_t b = 0; b < threadCount; b++)
+            cursors[b] = offsets[b * threadCount + t];
+
+        const size_t end = (t == threadCount - 1) ? m_Faces.size() : (t + 1) * faceStep;
+        for (size_t i = 3 * t * faceStep; i < 3 * end; i++)
+        {
+            const HalfEdge e = halfEdge(static_cast<CornerIndex>(i));
+            halfEdges[cursors[bucket(e.v0)]++] = e;
+        }
+    });
+
+    /* Sorting each bucket, by counting on the smallest vertex then on the few half-edges of each vertex, and pairing up the twins */
+
+    std::vector<HalfEdge> sortedHalfEdges(halfEdges.size());
+    std::vector<CornerIndex> opposites(3 * m_Faces.size(), InvalidIndex);
+
+    runInParallel([&](size_t t)
+    {
+        const size_t first = offsets[t * threadCount];
+        const size_t last = offsets[(t + 1) * threadCount];
+        const size_t firstVertex = (t * vertexCount + threadCount - 1) / threadCount;
+        const size_t lastVertex = ((t + 1) * vertexCount + threadCount - 1) / threadCount;
+
+        // Stable, so the half-edges of each vertex stay in face order
+        std::vector<size_t> vertexOffsets(lastVertex - firstVertex + 1, first);
+        for (size_t i = first; i < last; i++)
+            vertexOffsets[halfEdges[i].v0 - firstVertex + 1]++;
+        for (size_t v = 1; v < vertexOffsets.size(); v++)
+            vertexOffsets[v] += vertexOffsets[v - 1] - first;
+
+        std::vector<size_t> cursors(vertexOffsets.begin(), vertexOffsets.end() - 1);
+        for (size_t i = first; i < last; i++)
+            sortedHalfEdges[cursors[halfEdges[i].v0 - firstVertex]++] = halfEdges[i];
+
+        for (size_t v = 0; v + 1 < vertexOffsets.size(); v++)
+        {
+            const auto begin = sortedHalfEdges.begin() + vertexOffsets[v];
+            const auto end = sortedHalfEdges.begin() + vertexOffsets[v + 1];
+            std::sort(begin, end);
+
+            for (auto it = begin; it != end && it + 1 != end; )
+            {
+                if (it->v1 == (it + 1)->v1)
+                {
+                    opposites[it->corner] = (it + 1)->corner;
+                    opposites[(it + 1)->corner] = it->corner;
+                    it += 2;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+    });
+
+    /* Writing the neighbours, face by face */
+
+    runInParallel([&](size_t t)
+    {
+        const size_t end = (t == threadCount - 1) ? m_Faces.size() : (t + 1) * faceStep;
+        for (size_t i = t * faceStep; i < end; i++)
+        {
+            auto& f = m_Faces[i];
+            f.oppositeLocals = 0;
+            for (glm::length_t k = 0; k < 3; k++)
+            {
+                const CornerIndex opposite = opposites[cornerIndex(i, k)];
+                f.neighbours[k] = opposite == InvalidIndex ? InvalidIndex : cornerFace(opposite);
+                f.setOppositeLocal(k, opposite == InvalidIndex ? 0 : cornerLocal(opposite));
+            }
+        }
+    });
+
+    // Last face of each vertex, like addFace
+    for (size_t i = 0; i < m_Faces.size(); i++)
+        for (glm::length_t k = 0; k < 3; k++)
+            m_Vertices[m_Faces[i].indices[k]].faceIndex = static_cast<Index>(i);
+}
+
+TriangularMesh::Index TriangularMesh::addFirstFaceForTriangulation(size_t v0, size_t v1, size_t v2)
 {
     m_Faces.reserve(m_Faces.size() + 4);
 
@@ -101,21 +262,15 @@ size_t TriangularMesh::addFirstFaceForTriangulation(size_t v0, size_t v1, size_t
         fInf2.i1 = v0;
         fInf2.i2 = v2;
 
-    f.n0 = iFInf1;
-    f.n1 = iFInf2;
-    f.n2 = iFInf0;
-
-    fInf0.n0 = iF;
-    fInf0.n1 = iFInf2;
-    fInf0.n2 = iFInf1;
+    // Finite face and infinite faces are neighbours
+    linkFaces(iF, 0, iFInf1, 0);
+    linkFaces(iF, 1, iFInf2, 0);
+    linkFaces(iF, 2, iFInf0, 0);
 
-    fInf1.n0 = iF;
-    fInf1.n1 = iFInf0;
-    fInf1.n2 = iFInf2;
-
-    fInf2.n0 = iF;
-    fInf2.n1 = iFInf1;
-    fInf2.n2 = iFInf0;
+    // Infinite faces are neighbours of each other
+    linkFaces(iFInf0, 1, iFInf2, 2);
+    linkFaces(iFInf0, 2, iFInf1, 1);
+    linkFaces(iFInf1, 2, iFInf2, 1);
 
     // First face the infinite vertex is turning around is the first infinite face created
     infiniteVertex.faceIndex = iFInf0;
@@ -132,16 +287,19 @@ size_t TriangularMesh::addFirstFaceForTriangulation(size_t v0, size_t v1, size_t
 
 void TriangularMesh::faceSplit(size_t iF, const glm::vec3& vertexPosition)
 {
-    auto iv3 = addVertex(Vertex{ vertexPosition, 0});
+    faceSplit(iF, newVertex(Vertex{ vertexPosition, 0 }));
+}
+
+void TriangularMesh::faceSplit(size_t iF, size_t iv3)
+{
     auto& vertex3 = m_Vertices.at(iv3);
 
-    m_Faces.reserve(m_Faces.size() + 2);
+    const size_t if3 = newFace();
+    const size_t if4 = newFace();
 
     auto& f = m_Faces.at(iF);
-    size_t if3 = m_Faces.size();
-    auto& f3 = m_Faces.emplace_back();
-    size_t if4 = m_Faces.size();
-    auto& f4 = m_Faces.emplace_back();
+    auto& f3 = m_Faces.at(if3);
+    auto& f4 = m_Faces.at(if4);
 
     const glm::length_t v0 = 0, v1 = 1, v2 = 2;
 
@@ -157,13 +315,11 @@ void TriangularMesh::faceSplit(size_t iF, const glm::vec3& vertexPosition)
     const size_t if1 = f.neighbours[v1];
     const size_t if2 = f.neighbours[v2];
 
-    auto& f0 = m_Faces.at(if0);
-    auto& f1 = m_Faces.at(if1);
-    auto& f2 = m_Faces.at(if2);
+    const glm::length_t v00 = f.oppositeLocal(v0);
+    const glm::length_t v20 = f.oppositeLocal(v2);
 
-    const glm::length_t v00 = (localVertexIndex(iv1, if0) + 1) % 3;
-    const glm::length_t v10 = (localVertexIndex(iv2, if1) + 1) % 3;
-    const glm::length_t v20 = (localVertexIndex(iv0, if2) + 1) % 3;
+    const bool constrained0 = f.isConstrained(v0);
+    const bool constrained2 = f.isConstrained(v2);
 
     // Defining new faces (f3 & f4) vertex indices
     f3.i0 = iv3;
@@ -178,26 +334,27 @@ void TriangularMesh::faceSplit(size_t iF, const glm::vec3& vertexPosition)
     f.indices[v1] = iv3;
 
     // f0 and f4 are neighbors
-    f0.neighbours[v00] = if4;
-    f4.n0 = if0;
+    linkFaces(if4, 0, if0, v00);
 
     // f2 and f3 are neighbors
-    f2.neighbours[v20] = if3;
-    f3.n0 = if2;
+    linkFaces(if3, 0, if2, v20);
 
     // f and f1 were neighbors, and still are: no change
 
     // f3 and f4 are neighbors
-    f3.n1 = if4;
-    f4.n2 = if3;
+    linkFaces(if3, 1, if4, 2);
 
     // f4 and f are neighbors
-    f4.n1 = iF;
-    f.neighbours[v0] = if4;
+    linkFaces(if4, 1, iF, v0);
 
     // f and f3 are neighbors
-    f.neighbours[v2] = if3;
-    f3.n2 = iF;
+    linkFaces(iF, v2, if3, 2);
+
+    // Constrained edges of f moved to f3 and f4
+    f3.setConstrained(0, constrained2);
+    f4.setConstrained(0, constrained0);
+    f.setConstrained(v0, false);
+    f.setConstrained(v2, false);
 
     // Modiying the first face each vertex is turning around
     vertex0.faceIndex = if2;
@@ -210,63 +367,79 @@ TriangularMesh::Edge TriangularMesh::edgeFlip(size_t vertexIndex0, size_t vertex
 {
     //VRM_LOG_TRACE("Flipping edge between vertices {} and {}", vertexIndex0, vertexIndex1);
 
-    // Searching for incident faces
-    size_t if0 = 0, if1 = CWFaceIndex(vertexIndex0, firstFaceIndex(vertexIndex0));
-    glm::length_t v00 = 0;
-    glm::length_t v10 = 0;
-    bool found = false;
+    // Searching for the face where the edge goes from vertexIndex0 to vertexIndex1
     for (auto it = begin_turning_faces(vertexIndex0); it != end_turning_faces(vertexIndex0); ++it)
     {
-        if0 = if1;
-        if1 = *it;
-        const auto& f1 = m_Faces.at(if1);
-        auto vertexIndex0_localf1 = localVertexIndex(vertexIndex0, if1);
-
-        if (f1.indices[(vertexIndex0_localf1 + 1) % 3] == vertexIndex1)
-        {
-            found = true;
+        const auto& f = m_Faces.at(*it);
+        auto vertexIndex0_local = it.localVertexIndex();
 
-            v00 = (localVertexIndex(vertexIndex0, if0) + 1) % 3;
-            v10 = (localVertexIndex(vertexIndex1, if1) + 1) % 3;
-            break;
-        }
+        if (f.indices[(vertexIndex0_local + 1) % 3] == vertexIndex1)
+            return edgeFlip(*it, (vertexIndex0_local + 2) % 3);
     }
 
-    if (!found)
-        printFacesAroundVertexCCW(vertexIndex0);
-    VRM_ASSERT_MSG(found, "Edge not found.");
+    printFacesAroundVertexCCW(vertexIndex0);
+    VRM_ASSERT_MSG(false, "Edge not found.");
+
+    return Edge{};
+}
+
+TriangularMesh::Edge TriangularMesh::edgeFlip(size_t faceIndex, glm::length_t localEdgeIndex)
+{
+    /**
+     * Before:              After:
+     *        C                    C
+     *      / | \                / \
+     *     /  |  \              / g \
+     *    A f | g D            A --- D
+     *     \  |  /              \ f /
+     *      \ | /                \ /
+     *        B                    B
+     */
+    const glm::length_t a = localEdgeIndex;
+    const Index iF = static_cast<Index>(faceIndex);
+    const Index iG = m_Faces.at(iF).neighbours[a];
+    const glm::length_t d = oppositeLocalIndex(iF, a);
+
+    auto& f = m_Faces.at(iF);
+    auto& g = m_Faces.at(iG);
+
+    VRM_ASSERT_MSG(!f.isConstrained(a), "Constrained edges cannot be flipped.");
+
+    const Index iA = f.indices[a];
+    const Index iB = f.indices[(a + 1) % 3];
+    const Index iC = f.indices[(a + 2) % 3];
+    const Index iD = g.indices[d];
 
-    auto& f0 = m_Faces.at(if0);
-    auto& f1 = m_Faces.at(if1);
-    size_t ifp0 = f0.neighbours[(v00 + 1) % 3];
-    auto& fp0 = m_Faces.at(ifp0);
-    size_t ifp1 = f1.neighbours[(v10 + 1) % 3];
-    auto& fp1 = m_Faces.at(ifp1);
-    size_t iv00 = f0.indices[v00];
-    size_t iv11 = f1.indices[v10];
-    glm::length_t vp00 = localVertexIndex(iv00, ifp0);
-    glm::length_t vp10 = localVertexIndex(iv11, ifp1);
+    // Outer faces that change of side: CA goes from f to g, and BD from g to f
+    const Index iFCA = f.neighbours[(a + 1) % 3];
+    const Index iGBD = g.neighbours[(d + 1) % 3];
+    const glm::length_t fca = oppositeLocalIndex(iF, (a + 1) % 3);
+    const glm::length_t gbd = oppositeLocalIndex(iG, (d + 1) % 3);
+    const bool constrainedCA = f.isConstrained((a + 1) % 3);
+    const bool constrainedBD = g.isConstrained((d + 1) % 3);
 
-    // rearrange the faces
-    f0.indices[(v00 + 2) % 3] = iv11;
-    f0.neighbours[(v00 + 0) % 3] = ifp1;
-    fp1.neighbours[(vp10 + 2) % 3] = if0;
-    f0.neighbours[(v00 + 1) % 3] = if1;
+    // f becomes (A, B, D) and g becomes (D, C, A)
+    f.indices[(a + 2) % 3] = iD;
+    g.indices[(d + 2) % 3] = iA;
 
-    f1.indices[(v10 + 2) % 3] = iv00;
-    f1.neighbours[(v10 + 0) % 3] = ifp0;
-    fp0.neighbours[(vp00 + 2) % 3] = if1;
-    f1.neighbours[(v10 + 1) % 3] = if0;
+    linkFaces(iF, a, iGBD, gbd);
+    linkFaces(iG, d, iFCA, fca);
+    linkFaces(iF, (a + 1) % 3, iG, (d + 1) % 3);
+
+    f.setConstrained(a, constrainedBD);
+    g.setConstrained(d, constrainedCA);
+    f.setConstrained((a + 1) % 3, false);
+    g.setConstrained((d + 1) % 3, false);
 
     // New first faces
-    m_Vertices.at(vertexIndex0).faceIndex = if1;
-    m_Vertices.at(vertexIndex1).faceIndex = if0;
+    m_Vertices.at(iB).faceIndex = iF;
+    m_Vertices.at(iC).faceIndex = iG;
 
     return Edge{
-        .e0 = iv11,
-        .e1 = iv00,
-        .t0 = if1,
-        .t1 = if0
+        .e0 = iA,
+        .e1 = iD,
+        .t0 = iF,
+        .t1 = iG
     };
 }
 
@@ -304,324 +477,2014 @@ void TriangularMesh::edgeFlip(const glm::vec3& coords)
     }
 }
 
+void TriangularMesh::edgeSplit(size_t faceIndex, glm::length_t localEdgeIndex, size_t vertexIndex)
+{
+    /**
+     * Before:              After:
+     *        C                    C
+     *      / | \                / | \
+     *     /  |  \              / f2| g \
+     *    A f | g D            A -- M -- D
+     *     \  |  /              \ f |g2 /
+     *      \ | /                \ | /
+     *        B                    B
+     */
+    const glm::length_t a = localEdgeIndex;
+    const Index iF = static_cast<Index>(faceIndex);
+    const Index iG = m_Faces.at(iF).neighbours[a];
+    const glm::length_t d = oppositeLocalIndex(iF, a);
+
+    const Index iF2 = newFace();
+    const Index iG2 = newFace();
+
+    auto& f = m_Faces.at(iF);
+    auto& g = m_Faces.at(iG);
+    auto& f2 = m_Faces.at(iF2);
+    auto& g2 = m_Faces.at(iG2);
+
+    const Index iM = static_cast<Index>(vertexIndex);
+    const Index iA = f.indices[a];
+    const Index iB = f.indices[(a + 1) % 3];
+    const Index iC = f.indices[(a + 2) % 3];
+    const Index iD = g.indices[d];
+
+    // Outer faces that move to the new faces: CA goes from f to f2, and BD from g to g2
+    const Index iFCA = f.neighbours[(a + 1) % 3];
+    const Index iGBD = g.neighbours[(d + 1) % 3];
+    const glm::length_t fca = oppositeLocalIndex(iF, (a + 1) % 3);
+    const glm::length_t gbd = oppositeLocalIndex(iG, (d + 1) % 3);
+    const bool constrainedBC = f.isConstrained(a);
+    const bool constrainedCA = f.isConstrained((a + 1) % 3);
+    const bool constrainedBD = g.isConstrained((d + 1) % 3);
+
+    // f becomes (A, B, M), g becomes (D, C, M), and the new faces are f2 = (A, M, C) and g2 = (D, M, B)
+    f.indices[(a + 2) % 3] = iM;
+    g.indices[(d + 2) % 3] = iM;
+
+    f2.i0 = iA;
+    f2.i1 = iM;
+    f2.i2 = iC;
+
+    g2.i0 = iD;
+    g2.i1 = iM;
+    g2.i2 = iB;
+
+    linkFaces(iF2, 1, iFCA, fca);
+    linkFaces(iG2, 1, iGBD, gbd);
+    linkFaces(iF, a, iG2, 0);
+    linkFaces(iG, d, iF2, 0);
+    linkFaces(iF, (a + 1) % 3, iF2, 2);
+    linkFaces(iG, (d + 1) % 3, iG2, 2);
+
+    // Both halves of a constrained edge stay constrained
+    g2.setConstrained(0, constrainedBC);
+    f2.setConstrained(0, constrainedBC);
+    f2.setConstrained(1, constrainedCA);
+    g2.setConstrained(1, constrainedBD);
+    f.setConstrained((a + 1) % 3, false);
+    g.setConstrained((d + 1) % 3, false);
+
+    // New first faces
+    m_Vertices.at(iM).faceIndex = iF;
+    m_Vertices.at(iB).faceIndex = iF;
+    m_Vertices.at(iC).faceIndex = iG;
+}
+
+void TriangularMesh::removeVertex(size_t vertexIndex)
+{
+    VRM_ASSERT_MSG(m_IsForTriangulation, "Vertices can only be removed from a triangulation.");
+    VRM_ASSERT_MSG(vertexIndex != m_InfiniteVertexIndex && !isVertexFree(vertexIndex), "Vertex {} cannot be removed.", vertexIndex);
+    // n finite vertices make 2n - 2 faces, and at least 3 of them must remain
+    VRM_ASSERT_MSG(m_Faces.size() - m_FreeFaces.size() >= 6, "A triangulation needs at least 3 vertices.");
+
+    // Hole polygon in counter clockwise order, faces of the star, and the edges around the hole
+    std::vector<Index> polygon;
+    std::vector<Index> star;
+    std::vector<HoleEdge> boundary;
+
+    for (auto it = begin_turning_faces(vertexIndex); it != end_turning_faces(vertexIndex); ++it)
+    {
+        const auto& f = m_Faces.at(*it);
+        const glm::length_t local = it.localVertexIndex();
+
+        polygon.push_back(f.indices[(local + 1) % 3]);
+        star.push_back(static_cast<Index>(*it));
+        boundary.push_back(HoleEdge{
+            .from = f.indices[(local + 1) % 3],
+            .to = f.indices[(local + 2) % 3],
+            .outside = Corner{ f.neighbours[local], f.oppositeLocal(local) },
+            .constrained = f.isConstrained(local)
+        });
+    }
+
+    // The new triangles take the slots of the first faces of the star
+    std::vector<glm::vec<3, Index>> triangles;
+    fillHole(polygon, triangles);
+    setHoleTriangles(star, triangles, boundary);
+
+    // The two remaining faces and the vertex are freed
+    for (size_t t = triangles.size(); t < star.size(); t++)
+    {
+        auto& f = m_Faces.at(star.at(t));
+        f.indices = glm::vec<3, Index>(m_InfiniteVertexIndex);
+        f.neighbours = glm::vec<3, Index>(star.at(t));
+        m_FreeFaces.push_back(star.at(t));
+    }
+
+    m_Vertices.at(vertexIndex).faceIndex = InvalidIndex;
+    m_FreeVertices.push_back(static_cast<Index>(vertexIndex));
+}
+
+void TriangularMesh::removeVertex(const glm::vec3& coords)
+{
+    if (m_Faces.size() - m_FreeFaces.size() < 6)
+    {
+        VRM_LOG_ERROR("A triangulation needs at least 3 vertices.");
+        return;
+    }
+
+    if (auto containingFaceID = getFaceContainingPoint(coords); containingFaceID.has_value())
+    {
+        const auto& f = m_Faces.at(containingFaceID.value());
+
+        float minDistance = std::numeric_limits<float>::max();
+        size_t nearest = 0;
+        for (glm::length_t i = 0; i < 3; i++)
+        {
+            const glm::vec3 offset = m_Vertices.at(f.indices[i]).position - coords;
+            const float distance = offset.x * offset.x + offset.z * offset.z;
+
+            if (distance < minDistance)
+            {
+                minDistance = distance;
+                nearest = f.indices[i];
+            }
+        }
+
+        removeVertex(nearest);
+    }
+    else
+    {
+        VRM_LOG_ERROR("No vertex to remove here.");
+    }
+}
+
+void TriangularMesh::fillHole(const std::vector<Index>& polygon, std::vector<glm::vec<3, Index>>& triangles) const
+{
+    // Infinite triangles are always valid, they close the convex hull
+    auto isValid = [this](Index a, Index b, Index c) {
+        if (a == m_InfiniteVertexIndex || b == m_InfiniteVertexIndex || c == m_InfiniteVertexIndex)
+            return true;
+
+        return Predicates::Orient2D(planePosition(a), planePosition(b), planePosition(c)) > 0.0;
+    };
+
+    // The circle of an infinite triangle is the half-plane outside of its hull edge, plus the edge itself
+    auto isInCircle = [this](Index a, Index b, Index c, Index d) {
+        if (d == m_InfiniteVertexIndex)
+            return false;
+
+        if (b == m_InfiniteVertexIndex)
+            std::tie(a, b, c) = std::make_tuple(b, c, a);
+        else if (c == m_InfiniteVertexIndex)
+            std::tie(a, b, c) = std::make_tuple(c, a, b);
+
+        if (a != m_InfiniteVertexIndex)
+            return Predicates::InCircle(planePosition(a), planePosition(b), planePosition(c), planePosition(d)) > 0.0;
+
+        const double orientation = Predicates::Orient2D(planePosition(b), planePosition(c), planePosition(d));
+        if (orientation != 0.0)
+            return orientation > 0.0;
+
+        return glm::dot(planePosition(d) - planePosition(b), planePosition(d) - planePosition(c)) < 0.0;
+    };
+
+    // Each polygon is split by the Delaunay triangle on its first edge, and the two
+    // remaining polygons start with the edges of that triangle.
+    std::vector<std::vector<Index>> holes = { polygon };
+
+    while (!holes.empty())
+    {
+        const std::vector<Index> hole = std::move(holes.back());
+        holes.pop_back();
+
+        const Index a = hole.at(0);
+        const Index b = hole.at(1);
+
+        size_t best = 0;
+        for (size_t k = 2; k < hole.size(); k++)
+        {
+            if (!isValid(a, b, hole.at(k)))
+                continue;
+
+            if (best == 0 || isInCircle(a, b, hole.at(best), hole.at(k)))
+                best = k;
+        }
+
+        VRM_ASSERT_MSG(best != 0, "No Delaunay triangle found to fill the hole.");
+
+        triangles.emplace_back(a, b, hole.at(best));
+
+        if (best > 2)
+        {
+            std::vector<Index>& next = holes.emplace_back(1, hole.at(best));
+            next.insert(next.end(), hole.begin() + 1, hole.begin() + best);
+        }
+
+        if (best + 1 < hole.size())
+        {
+            std::vector<Index>& next = holes.emplace_back(1, a);
+            next.insert(next.end(), hole.begin() + best, hole.end());
+        }
+    }
+}
+
+void TriangularMesh::setHoleTriangles(const std::vector<Index>& faces, std::vector<glm::vec<3, Index>>& triangles, const std::vector<HoleEdge>& boundary)
+{
+    VRM_ASSERT(faces.size() >= triangles.size());
+
+    // Face and local index of each new half-edge
+    std::unordered_map<std::pair<size_t, size_t>, Corner> halfEdges;
+    halfEdges.reserve(3 * triangles.size());
+
+    for (size_t t = 0; t < triangles.size(); t++)
+    {
+        auto& triangle = triangles.at(t);
+
+        // Infinite faces always start with the infinite vertex
+        while (triangle[1] == m_InfiniteVertexIndex || triangle[2] == m_InfiniteVertexIndex)
+            triangle = glm::vec<3, Index>(triangle[1], triangle[2], triangle[0]);
+
+        auto& f = m_Faces.at(faces.at(t));
+        f.indices = triangle;
+        f.constraints = 0;
+
+        for (glm::length_t j = 0; j < 3; j++)
+        {
+            m_Vertices.at(triangle[j]).faceIndex = faces.at(t);
+            halfEdges[{ triangle[(j + 1) % 3], triangle[(j + 2) % 3] }] = Corner{ faces.at(t), j };
+        }
+    }
+
+    // Edges between two new triangles
+    for (const auto& [edge, corner] : halfEdges)
+        if (auto twin = halfEdges.find({ edge.second, edge.first }); twin != halfEdges.end() && edge.first < edge.second)
+            linkFaces(corner.face, corner.local, twin->second.face, twin->second.local);
+
+    // Edges of the hole are linked to the faces around it. A hole pinched around a vertex also has an edge between
+    // two of its own faces, which is seen from both sides: it is already linked above and only keeps its constraint.
+    const std::unordered_set<Index> holeFaces(faces.begin(), faces.end());
+    for (const auto& edge : boundary)
+    {
+        const Corner& corner = halfEdges.at({ edge.from, edge.to });
+        if (!holeFaces.contains(edge.outside.face))
+            linkFaces(corner.face, corner.local, edge.outside.face, edge.outside.local);
+        m_Faces.at(corner.face).setConstrained(corner.local, edge.constrained);
+    }
+}
+
+bool TriangularMesh::insertConstraint(size_t vertexIndex0, size_t vertexIndex1)
+{
+    VRM_ASSERT_MSG(m_IsForTriangulation, "Constraints can only be inserted in a triangulation.");
+    VRM_ASSERT_MSG(vertexIndex0 != m_InfiniteVertexIndex && vertexIndex1 != m_InfiniteVertexIndex, "Constraints cannot end on the infinite vertex.");
+    VRM_ASSERT_MSG(!isVertexFree(vertexIndex0) && !isVertexFree(vertexIndex1), "Constraints cannot end on a removed vertex.");
+
+    if (vertexIndex0 == vertexIndex1)
+        return true;
+
+    const glm::dvec2 A = planePosition(vertexIndex0);
+    const glm::dvec2 B = planePosition(vertexIndex1);
+
+    auto orientation = [&](Index w) { return Predicates::Orient2D(A, B, planePosition(w)); };
+
+    // A vertex lying on the segment splits it in two constraints
+    auto isOnSegment = [&](Index w) {
+        return w != m_InfiniteVertexIndex && orientation(w) == 0.0 && glm::dot(planePosition(w) - A, B - planePosition(w)) > 0.0;
+    };
+
+    // Searching for the first crossed face around the first vertex
+    Index face = InvalidIndex;
+    glm::length_t crossed = 0;
+
+    for (auto it = begin_turning_faces(vertexIndex0); it != end_turning_faces(vertexIndex0); ++it)
+    {
+        const auto& f = m_Faces.at(*it);
+        const glm::length_t local = it.localVertexIndex();
+        const Index p = f.indices[(local + 1) % 3];
+        const Index q = f.indices[(local + 2) % 3];
+
+        // The edge already exists
+        if (p == vertexIndex1)
+        {
+            setEdgeConstrained(*it, (local + 2) % 3, true);
+            return true;
+        }
+
+        if (isOnSegment(p))
+            return insertConstraint(p, vertexIndex1) && insertConstraint(vertexIndex0, p);
+
+        if (isFaceInfinite(*it))
+            continue;
+
+        if (orientation(p) < 0.0 && orientation(q) > 0.0)
+        {
+            face = static_cast<Index>(*it);
+            crossed = local;
+            break;
+        }
+    }
+
+    VRM_ASSERT_MSG(face != InvalidIndex, "No face crossed by the constraint.");
+
+    // Crossed faces, vertices on the left and on the right of the segment, and the edges around the crossed faces
+    std::vector<Index> faces = { face };
+    std::vector<Index> left = { m_Faces.at(face).indices[(crossed + 2) % 3] };
+    std::vector<Index> right = { m_Faces.at(face).indices[(crossed + 1) % 3] };
+    std::vector<HoleEdge> boundary;
+
+    auto addBoundary = [this, &boundary](Index faceIndex, glm::length_t local) {
+        const auto& f = m_Faces.at(faceIndex);
+        boundary.push_back(HoleEdge{
+            .from = f.indices[(local + 1) % 3],
+            .to = f.indices[(local + 2) % 3],
+            .outside = Corner{ f.neighbours[local], f.oppositeLocal(local) },
+            .constrained = f.isConstrained(local)
+        });
+    };
+
+    addBoundary(face, (crossed + 1) % 3);
+    addBoundary(face, (crossed + 2) % 3);
+
+    // Walking along the segment. The crossed edge always goes from the right to the left.
+    for (;;)
+    {
+        const auto& f = m_Faces.at(face);
+
+        if (f.isConstrained(crossed))
+        {
+            VRM_LOG_ERROR("Constraint between vertices {} and {} crosses another constraint.", vertexIndex0, vertexIndex1);
+            return false;
+        }
+
+        const Index next = f.neighbours[crossed];
+        const glm::length_t o = f.oppositeLocal(crossed);
+        const Index w = m_Faces.at(next).indices[o];
+
+        faces.push_back(next);
+
+        if (w == vertexIndex1)
+        {
+            addBoundary(next, (o + 1) % 3);
+            addBoundary(next, (o + 2) % 3);
+            break;
+        }
+
+        // The part before the vertex crosses no constraint, so it is only inserted once the rest has been, which
+        // leaves the triangulation as it was if the rest is rejected
+        if (isOnSegment(w))
+            return insertConstraint(w, vertexIndex1) && insertConstraint(vertexIndex0, w);
+
+        if (orientation(w) > 0.0)
+        {
+            left.push_back(w);
+            addBoundary(next, (o + 2) % 3);
+            crossed = (o + 1) % 3;
+        }
+        else
+        {
+            right.push_back(w);
+            addBoundary(next, (o + 1) % 3);
+            crossed = (o + 2) % 3;
+        }
+
+        face = next;
+    }
+
+    // Both sides are filled with constrained Delaunay triangles, starting with the segment
+    std::vector<Index> upper = { static_cast<Index>(vertexIndex0), static_cast<Index>(vertexIndex1) };
+    upper.insert(upper.end(), left.rbegin(), left.rend());
+
+    std::vector<Index> lower = { static_cast<Index>(vertexIndex1), static_cast<Index>(vertexIndex0) };
+    lower.insert(lower.end(), right.begin(), right.end());
+
+    std::vector<glm::vec<3, Index>> triangles;
+    fillHole(upper, triangles);
+    fillHole(lower, triangles);
+    setHoleTriangles(faces, triangles, boundary);
+
+    // The first triangle is built on the segment
+    setEdgeConstrained(faces.front(), 2, true);
+
+    return true;
+}
+
+size_t TriangularMesh::insertBreaklines(const std::filesystem::path& path, const std::function<size_t(size_t)>& vertexIndex, size_t* segmentCount)
+{
+    VRM_ASSERT_MSG(m_IsForTriangulation, "Breaklines can only be inserted in a triangulation.");
+
+    const MappedFile file(path);
+    VRM_ASSERT_MSG(file.isOpen(), "Couldn't open file {}.", path.string());
+
+    const std::string name = path.filename().string();
+    std::string_view text = file.getContent();
+    std::string_view header = TextParser::NextLine(text);
+
+    size_t expectedCount = 0;
+    if (!TextParser::ParseNumber(header, expectedCount))
+        VRM_LOG_WARN("{}:1: missing breaklines count.", name);
+
+    auto isTriangulated = [this](size_t v) { return v < getVertexCount() && !isVertexInfinite(v) && !isVertexFree(v); };
+
+    size_t count = 0;
+    size_t insertedCount = 0;
+
+    for (size_t lineNumber = 2; !text.empty(); lineNumber++)
+    {
+        const std::string_view content = TextParser::NextLine(text);
+        if (content.find_first_not_of(" \t") == std::string_view::npos)
+            continue;
+
+        count++;
+
+        std::string_view line = content;
+        size_t i0, i1;
+        if (!TextParser::ParseNumber(line, i0) || !TextParser::ParseNumber(line, i1))
+        {
+            VRM_LOG_WARN("{}:{}: malformed breakline \"{}\" skipped.", name, lineNumber, content);
+            continue;
+        }
+
+        const size_t v0 = vertexIndex ? vertexIndex(i0) : i0;
+        const size_t v1 = vertexIndex ? vertexIndex(i1) : i1;
+        if (!isTriangulated(v0) || !isTriangulated(v1))
+        {
+            VRM_LOG_WARN("{}:{}: breakline between points {} and {} skipped, both must be triangulated vertices.", name, lineNumber, i0, i1);
+            continue;
+        }
+
+        insertedCount += insertConstraint(v0, v1);
+    }
+
+    if (count != expectedCount)
+        VRM_LOG_WARN("{}: {} breaklines announced, {} found.", name, expectedCount, count);
+
+    if (segmentCount)
+        *segmentCount = count;
+
+    return insertedCount;
+}
+
+bool TriangularMesh::isEdgeConstrained(size_t faceIndex, glm::length_t localEdgeIndex) const
+{
+    return m_Faces.at(faceIndex).isConstrained(localEdgeIndex);
+}
+
+void TriangularMesh::setEdgeConstrained(size_t faceIndex, glm::length_t localEdgeIndex, bool constrained)
+{
+    auto& f = m_Faces.at(faceIndex);
+    f.setConstrained(localEdgeIndex, constrained);
+    m_Faces.at(f.neighbours[localEdgeIndex]).setConstrained(f.oppositeLocal(localEdgeIndex), constrained);
+}
+
 bool TriangularMesh::isFaceInfinite(size_t faceIndex) const
 {
     if (!m_IsForTriangulation)
         return false;
-        
-    for (auto it = begin_turning_faces(m_InfiniteVertexIndex); it != end_turning_faces(m_InfiniteVertexIndex); ++it)
+
+    // A face is infinite if and only if the infinite vertex is one of its vertices
+    const auto& f = m_Faces.at(faceIndex);
+
+    return f.i0 == m_InfiniteVertexIndex || f.i1 == m_InfiniteVertexIndex || f.i2 == m_InfiniteVertexIndex;
+}
+
+TriangularMesh::Index TriangularMesh::locateFace(const glm::vec3& vertexPosition, std::optional<size_t> hintFaceIndex, std::optional<Corner>* blockingConstraint) const
+{
+    VRM_ASSERT_MSG(m_IsForTriangulation, "Point location is only available on triangulations.");
+
+    size_t currentFace = hintFaceIndex.has_value() ? hintFaceIndex.value()
+        : m_HierarchyLevels.empty() ? m_Vertices.back().faceIndex : descendHierarchy(vertexPosition);
+
+    // The hint may come from a removed vertex
+    if (currentFace >= m_Faces.size() || isFaceFree(currentFace))
+        currentFace = m_Vertices.at(m_InfiniteVertexIndex).faceIndex;
+
+    if (isFaceInfinite(currentFace))
+    {
+        const auto& f = m_Faces.at(currentFace);
+        auto iInfVertex_local = localVertexIndex(m_InfiniteVertexIndex, currentFace);
+
+        if (canPointSeeEdge(vertexPosition, f.indices[(iInfVertex_local + 2) % 3], f.indices[(iInfVertex_local + 1) % 3]))
+            return currentFace;
+
+        currentFace = f.neighbours[iInfVertex_local];
+    }
+
+    // Visibility walk. The first tested edge is chosen pseudo-randomly at each step, otherwise
+    // the walk could cycle forever on a non-Delaunay triangulation (naive mode).
+    size_t previousFace = currentFace;
+    uint32_t random = static_cast<uint32_t>(currentFace);
+
+    for (;;)
+    {
+        const auto& f = m_Faces.at(currentFace);
+        random = random * 1664525u + 1013904223u;
+        const glm::length_t offset = static_cast<glm::length_t>((random >> 16) % 3);
+
+        bool moved = false;
+        for (glm::length_t k = 0; k < 3; k++)
+        {
+            const glm::length_t i = (offset + k) % 3;
+            const size_t nextFace = f.neighbours[(i + 2) % 3];
+
+            // No need to test the edge we just crossed
+            if (nextFace == previousFace)
+                continue;
+
+            if (canPointSeeEdge(vertexPosition, f.indices[i], f.indices[(i + 1) % 3]))
+            {
+                if (blockingConstraint && f.isConstrained((i + 2) % 3))
+                {
+                    *blockingConstraint = Corner{ static_cast<Index>(currentFace), (i + 2) % 3 };
+                    return currentFace;
+                }
+
+                previousFace = currentFace;
+                currentFace = nextFace;
+                moved = true;
+                break;
+            }
+        }
+
+        // Either the point is inside the current face, or we just went out of the convex hull
+        if (!moved || isFaceInfinite(currentFace))
+            return currentFace;
+    }
+}
+
+std::optional<TriangularMesh::Index> TriangularMesh::getFaceContainingPoint(const glm::vec3& vertexPosition, std::optional<size_t> hintFaceIndex) const
+{
+    if (m_Faces.empty())
+        return std::nullopt;
+
+    size_t faceIndex = locateFace(vertexPosition, hintFaceIndex);
+
+    if (isFaceInfinite(faceIndex))
+        return std::nullopt;
+
+    return faceIndex;
+}
+
+bool TriangularMesh::canPointSeeEdge(const glm::vec3& point, size_t vertexIndex0, size_t vertexIndex1) const
+{
+    const auto& v0 = m_Vertices.at(vertexIndex0).position;
+    const auto& v1 = m_Vertices.at(vertexIndex1).position;
+
+    const glm::dvec2 A = glm::dvec2(v0.x, -v0.z);
+    const glm::dvec2 B = glm::dvec2(v1.x, -v1.z);
+    const glm::dvec2 P = glm::dvec2(point.x, -point.z);
+
+    return Predicates::Orient2D(A, B, P) < 0.0;
+}
+
+bool TriangularMesh::isHullEdgeVisible(size_t faceIndex, const glm::vec3& point) const
+{
+    const auto& f = m_Faces.at(faceIndex);
+    const glm::length_t iInfVertex_local = localVertexIndex(m_InfiniteVertexIndex, faceIndex);
+
+    return canPointSeeEdge(point, f.indices[(iInfVertex_local + 2) % 3], f.indices[(iInfVertex_local + 1) % 3]);
+}
+
+TriangularMesh::Index TriangularMesh::nextHullFace(size_t faceIndex) const
+{
+    return m_Faces.at(faceIndex).neighbours[(localVertexIndex(m_InfiniteVertexIndex, faceIndex) + 1) % 3];
+}
+
+TriangularMesh::Index TriangularMesh::previousHullFace(size_t faceIndex) const
+{
+    return m_Faces.at(faceIndex).neighbours[(localVertexIndex(m_InfiniteVertexIndex, faceIndex) + 2) % 3];
+}
+
+TriangularMesh::Index TriangularMesh::addVertex_StreamingTriangulation(const glm::vec3& vertexPosition)
+{
+    std::vector<Index> levelFaces;
+    size_t hintFaceIndex = m_HierarchyLevels.empty() ? m_Vertices.back().faceIndex : descendHierarchy(vertexPosition, &levelFaces);
+    size_t vertexIndex = newVertex(Vertex{ vertexPosition, 0 });
+
+    insertVertex_StreamingTriangulation(vertexIndex, hintFaceIndex);
+
+    if (m_IsHierarchyEnabled && !isVertexFree(vertexIndex))
+        insertInHierarchy(vertexIndex, levelFaces);
+
+    return vertexIndex;
+}
+
+void TriangularMesh::insertVertex_StreamingTriangulation(size_t vertexIndex, size_t hintFaceIndex)
+{
+    const glm::vec3 vertexPosition = m_Vertices.at(vertexIndex).position;
+
+    const size_t containingFaceID = locateFace(vertexPosition, hintFaceIndex);
+
+    if (!isFaceInfinite(containingFaceID))
+    {
+        if (isPointAtFaceVertex(containingFaceID, vertexPosition))
+        {
+            m_Vertices.at(vertexIndex).faceIndex = InvalidIndex;
+            return;
+        }
+
+        // Exactly on an edge, even on the hull: splitting the face would leave a flat triangle, so the edge is split
+        const auto& f = m_Faces.at(containingFaceID);
+        const glm::dvec2 p(vertexPosition.x, -vertexPosition.z);
+
+        for (glm::length_t k = 0; k < 3; k++)
+        {
+            if (Predicates::Orient2D(planePosition(f.indices[(k + 1) % 3]), planePosition(f.indices[(k + 2) % 3]), p) == 0.0)
+            {
+                edgeSplit(containingFaceID, k, vertexIndex);
+                return;
+            }
+        }
+
+        faceSplit(containingFaceID, vertexIndex);
+        return;
+    }
+
+    // Outside of the convex hull: the located infinite face is behind a hull edge visible from the point.
+    // The visible part of the hull is grown from it in both directions along the ring of infinite faces.
+    VRM_ASSERT_MSG(isHullEdgeVisible(containingFaceID, vertexPosition), "The located hull edge should be visible from the point.");
+
+    Index first = static_cast<Index>(containingFaceID);
+    Index last = first;
+
+    while (previousHullFace(first) != last && isHullEdgeVisible(previousHullFace(first), vertexPosition))
+        first = previousHullFace(first);
+
+    while (nextHullFace(last) != first && isHullEdgeVisible(nextHullFace(last), vertexPosition))
+        last = nextHullFace(last);
+
+    // The faces are modified on the way, so their order is kept beforehand
+    std::vector<Index> visibleFaces = { first };
+    while (visibleFaces.back() != last)
+        visibleFaces.push_back(nextHullFace(visibleFaces.back()));
+
+    // For the first one, we only split the face:
+    faceSplit(first, vertexIndex);
+
+    // For the other ones, we will flip an infinite edge:
+    for (size_t k = 1; k < visibleFaces.size(); k++)
+    {
+        auto iInfVertex_local = localVertexIndex(m_InfiniteVertexIndex, visibleFaces[k]);
+        edgeFlip(visibleFaces[k], (iInfVertex_local + 2) % 3);
+    }
+}
+
+bool TriangularMesh::isPointAtFaceVertex(size_t faceIndex, const glm::vec3& point) const
+{
+    const glm::dvec2 p(point.x, -point.z);
+    const auto& f = m_Faces.at(faceIndex);
+
+    return planePosition(f.i0) == p || planePosition(f.i1) == p || planePosition(f.i2) == p;
+}
+
+bool TriangularMesh::isEdgeDelaunay(const Edge& edge) const
+{
+    // (A, B, C) is the counter clockwise triangle t0
+    const auto& t0 = m_Faces.at(edge.t0);
+    const auto& t1 = m_Faces.at(edge.t1);
+    const auto& A = m_Vertices.at(edge.e1).position;
+    const auto& B = m_Vertices.at(edge.e0).position;
+    const auto& C = m_Vertices.at(t0.indices[(localVertexIndex(edge.e0, edge.t0) + 1) % 3]).position;
+    const auto& D = m_Vertices.at(t1.indices[(localVertexIndex(edge.e1, edge.t1) + 1) % 3]).position;
+
+    // D must not be strictly inside the circumcircle of t0. Cocircular points are left as they are,
+    // otherwise the same edge could be flipped back and forth.
+    return Predicates::InCircle(
+        glm::dvec2(A.x, -A.z),
+        glm::dvec2(B.x, -B.z),
+        glm::dvec2(C.x, -C.z),
+        glm::dvec2(D.x, -D.z)
+    ) <= 0.0;
+}
+
+bool TriangularMesh::isEdgeDelaunay(size_t faceIndex, glm::length_t localEdgeIndex) const
+{
+    const auto& f = m_Faces.at(faceIndex);
+    const auto& A = m_Vertices.at(f.indices[localEdgeIndex]).position;
+    const auto& B = m_Vertices.at(f.indices[(localEdgeIndex + 1) % 3]).position;
+    const auto& C = m_Vertices.at(f.indices[(localEdgeIndex + 2) % 3]).position;
+    const auto& D = m_Vertices.at(m_Faces.at(f.neighbours[localEdgeIndex]).indices[oppositeLocalIndex(faceIndex, localEdgeIndex)]).position;
+
+    return Predicates::InCircle(
+        glm::dvec2(A.x, -A.z),
+        glm::dvec2(B.x, -B.z),
+        glm::dvec2(C.x, -C.z),
+        glm::dvec2(D.x, -D.z)
+    ) <= 0.0;
+}
+
+int TriangularMesh::addVertex_StreamingDelaunayTriangulation(const glm::vec3& vertexPosition, InsertionKernel kernel)
+{
+    std::vector<Index> levelFaces;
+    size_t hintFaceIndex = m_HierarchyLevels.empty() ? m_Vertices.back().faceIndex : descendHierarchy(vertexPosition, &levelFaces);
+    size_t vertexIndex = newVertex(Vertex{ vertexPosition, 0 });
+
+    const int flipsCount = insertVertex_StreamingDelaunayTriangulation(vertexIndex, hintFaceIndex, kernel);
+
+    if (m_IsHierarchyEnabled && !isVertexFree(vertexIndex))
+        insertInHierarchy(vertexIndex, levelFaces);
+
+    return flipsCount;
+}
+
+void TriangularMesh::setHierarchyEnabled(bool enabled)
+{
+    m_IsHierarchyEnabled = enabled;
+    buildHierarchy();
+}
+
+void TriangularMesh::buildHierarchy()
+{
+    m_HierarchyLevels.clear();
+
+    if (m_IsHierarchyEnabled)
+        growHierarchy();
+}
+
+void TriangularMesh::growHierarchy()
+{
+    if (!m_IsForTriangulation)
+        return;
+
+    while (m_HierarchyLevels.size() < HierarchyMaxLevels)
+    {
+        const TriangularMesh& top = m_HierarchyLevels.empty() ? *this : m_HierarchyLevels.back().mesh;
+
+        // Small enough to be walked through
+        if (top.getVertexCount() < HierarchyRatio * HierarchyRatio)
+            return;
+
+        HierarchyLevel level;
+        std::vector<glm::vec3> points;
+
+        for (size_t i = 0; i < top.getVertexCount(); i++)
+        {
+            if (i == top.m_InfiniteVertexIndex || top.isVertexFree(i) || nextHierarchyRandom() % HierarchyRatio != 0)
+                continue;
+
+            points.push_back(top.m_Vertices.at(i).position);
+            level.down.push_back(static_cast<Index>(i));
+        }
+
+        if (points.size() < 3)
+            return;
+
+        level.mesh.buildDelaunay(points);
+        // The infinite vertex of the level has no counterpart
+        level.down.resize(level.mesh.getVertexCount(), InvalidIndex);
+
+        m_HierarchyLevels.push_back(std::move(level));
+    }
+}
+
+TriangularMesh::Index TriangularMesh::descendHierarchy(const glm::vec3& point, std::vector<Index>* levelFaces) const
+{
+    if (levelFaces)
+        levelFaces->assign(m_HierarchyLevels.size(), InvalidIndex);
+
+    std::optional<size_t> hintFaceIndex;
+
+    for (size_t k = m_HierarchyLevels.size(); k-- > 0; )
+    {
+        const auto& level = m_HierarchyLevels.at(k);
+        const Index faceIndex = level.mesh.locateFace(point, hintFaceIndex);
+
+        if (levelFaces)
+            levelFaces->at(k) = faceIndex;
+
+        // The walk in the level below starts next to the nearest vertex
+        const TriangularMesh& below = k == 0 ? *this : m_HierarchyLevels.at(k - 1).mesh;
+        hintFaceIndex = below.m_Vertices.at(level.down.at(level.mesh.nearestVertex(faceIndex, point))).faceIndex;
+    }
+
+    return static_cast<Index>(hintFaceIndex.value_or(m_Vertices.back().faceIndex));
+}
+
+void TriangularMesh::insertInHierarchy(size_t vertexIndex, const std::vector<Index>& levelFaces)
+{
+    Index belowVertexIndex = static_cast<Index>(vertexIndex);
+
+    for (size_t k = 0; k < m_HierarchyLevels.size() && nextHierarchyRandom() % HierarchyRatio == 0; k++)
+    {
+        auto& level = m_HierarchyLevels.at(k);
+        const Index levelVertexIndex = level.mesh.newVertex(Vertex{ m_Vertices.at(vertexIndex).position, 0 });
+
+        level.mesh.insertVertex_StreamingDelaunayTriangulation(levelVertexIndex, levelFaces.at(k));
+        level.down.resize(level.mesh.getVertexCount(), InvalidIndex);
+        level.down.at(levelVertexIndex) = belowVertexIndex;
+
+        belowVertexIndex = levelVertexIndex;
+    }
+
+    growHierarchy();
+}
+
+TriangularMesh::Index TriangularMesh::nearestVertex(size_t faceIndex, const glm::vec3& point) const
+{
+    const auto& f = m_Faces.at(faceIndex);
+    const glm::dvec2 p = glm::dvec2(point.x, -point.z);
+
+    Index nearest = InvalidIndex;
+    double nearestDistance = std::numeric_limits<double>::max();
+
+    for (glm::length_t j = 0; j < 3; j++)
+    {
+        if (f.indices[j] == m_InfiniteVertexIndex)
+            continue;
+
+        if (const double distance = glm::distance(planePosition(f.indices[j]), p); distance < nearestDistance)
+        {
+            nearest = f.indices[j];
+            nearestDistance = distance;
+        }
+    }
+
+    return nearest;
+}
+
+void TriangularMesh::buildDelaunay(std::span<const glm::vec3> points)
+{
+    SweepDelaunay delaunay(points);
+
+    if (delaunay.getSkippedCount() > 0)
+        VRM_LOG_WARN("{} duplicate points were not triangulated.", delaunay.getSkippedCount());
+
+    setTriangulation(points, delaunay.getTriangles(), delaunay.getHalfEdges());
+}
+
+void TriangularMesh::buildDelaunayParallel(std::span<const glm::vec3> points, size_t threadCount)
+{
+    constexpr uint32_t Invalid = SweepDelaunay::Invalid;
+    constexpr size_t minPointsPerStrip = 1'024;
+
+    const size_t n = points.size();
+    const size_t stripCount = std::min(threadCount, n / minPointsPerStrip);
+
+    if (stripCount < 2)
+    {
+        buildDelaunay(points);
+        return;
+    }
+
+    auto runInParallel = [stripCount](const auto& work)
+    {
+        std::vector<std::thread> threads;
+        for (size_t k = 0; k < stripCount; k++)
+            threads.emplace_back(work, k);
+
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    /* Splitting the points into vertical strips of equal sizes */
+
+    struct Strip
+    {
+        float minX, maxX;
+
+        std::vector<uint32_t> triangles; // Global vertex indices
+        std::vector<uint32_t> halfEdges; // Local half-edge indices
+        std::vector<bool> isFinal;
+
+        // Local index of the first half-edge of each final triangle, among the final triangles of the strip
+        std::vector<uint32_t> finalFirstHalfEdge;
+        uint32_t finalHalfEdgeCount = 0;
+
+        // Vertices of non final triangles and of the strip hull, possibly repeated
+        std::vector<uint32_t> seamVertices;
+
+        // Final half-edges, in global indices, with their opposite half-edge in the seam triangulation
+        std::vector<std::pair<uint32_t, uint32_t>> seamBoundary;
+    };
+
+    std::vector<Strip> strips(stripCount);
+
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    auto lessX = [&points](uint32_t a, uint32_t b) {
+        return points[a].x < points[b].x || (points[a].x == points[b].x && points[a].z < points[b].z);
+    };
+
+    std::vector<size_t> bounds(stripCount + 1);
+    for (size_t k = 0; k <= stripCount; k++)
+        bounds[k] = n * k / stripCount;
+
+    // Both halves of each partition are split further on their own thread
+    auto split = [&](auto&& self, size_t k0, size_t k1) -> void {
+        if (k1 - k0 < 2)
+        {
+            Strip& strip = strips[k0];
+            strip.minX = std::numeric_limits<float>::max();
+            strip.maxX = std::numeric_limits<float>::lowest();
+
+            for (size_t i = bounds[k0]; i < bounds[k1]; i++)
+            {
+                strip.minX = std::min(strip.minX, points[order[i]].x);
+                strip.maxX = std::max(strip.maxX, points[order[i]].x);
+            }
+            return;
+        }
+
+        const size_t km = (k0 + k1) / 2;
+        std::nth_element(order.begin() + bounds[k0], order.begin() + bounds[km], order.begin() + bounds[k1], lessX);
+
+        std::thread left([&self, k0, km] { self(self, k0, km); });
+        self(self, km, k1);
+        left.join();
+    };
+    split(split, 0, stripCount);
+
+    /* Triangulating each strip on its own thread */
+
+    runInParallel([&](size_t k)
+    {
+        Strip& strip = strips[k];
+
+        std::vector<glm::vec3> stripPoints;
+        stripPoints.reserve(bounds[k + 1] - bounds[k]);
+        for (size_t i = bounds[k]; i < bounds[k + 1]; i++)
+            stripPoints.push_back(points[order[i]]);
+
+        SweepDelaunay delaunay(stripPoints);
+
+        strip.triangles = delaunay.getTriangles();
+        strip.halfEdges = delaunay.getHalfEdges();
+
+        for (auto& v : strip.triangles)
+            v = order[bounds[k] + v];
+
+        // A triangle is final if its circumcircle cannot reach the points of the other strips
+        const double leftBound = k > 0 ? strips[k - 1].maxX : -std::numeric_limits<double>::infinity();
+        const double rightBound = k + 1 < stripCount ? strips[k + 1].minX : std::numeric_limits<double>::infinity();
+
+        const size_t triangleCount = strip.triangles.size() / 3;
+        strip.isFinal.resize(triangleCount);
+        strip.finalFirstHalfEdge.assign(triangleCount, Invalid);
+
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            const glm::vec3& A = points[strip.triangles[3 * t + 0]];
+            const glm::vec3& B = points[strip.triangles[3 * t + 1]];
+            const glm::vec3& C = points[strip.triangles[3 * t + 2]];
+
+            const glm::dvec2 d = glm::dvec2(B.x - A.x, A.z - B.z);
+            const glm::dvec2 e = glm::dvec2(C.x - A.x, A.z - C.z);
+            const double bl = glm::dot(d, d);
+            const double cl = glm::dot(e, e);
+            const double det = 0.5 / (d.x * e.y - d.y * e.x);
+            const glm::dvec2 offset = glm::dvec2((e.y * bl - d.y * cl) * det, (d.x * cl - e.x * bl) * det);
+
+            const double centerX = A.x + offset.x;
+            // Slightly enlarged to stay on the safe side of rounding errors
+            const double radius = glm::length(offset) * (1.0 + 1e-9);
+
+            strip.isFinal[t] = std::isfinite(radius) && centerX - radius > leftBound && centerX + radius < rightBound;
+
+            if (strip.isFinal[t])
+            {
+                strip.finalFirstHalfEdge[t] = strip.finalHalfEdgeCount;
+                strip.finalHalfEdgeCount += 3;
+            }
+        }
+
+        for (size_t h = 0; h < strip.triangles.size(); h++)
+        {
+            if (!strip.isFinal[h / 3] || strip.halfEdges[h] == Invalid)
+                strip.seamVertices.push_back(strip.triangles[h]);
+            if (strip.halfEdges[h] == Invalid)
+                strip.seamVertices.push_back(strip.triangles[h - h % 3 + (h + 1) % 3]);
+        }
+    });
+
+    /* Triangulating the seams */
+
+    std::vector<uint32_t> seamIndex(n, Invalid);
+    std::vector<uint32_t> seamVertices;
+    std::vector<glm::vec3> seamPoints;
+
+    for (const auto& strip : strips)
+    {
+        for (uint32_t v : strip.seamVertices)
+        {
+            if (seamIndex[v] != Invalid)
+                continue;
+            seamIndex[v] = static_cast<uint32_t>(seamVertices.size());
+            seamVertices.push_back(v);
+            seamPoints.push_back(points[v]);
+        }
+    }
+
+    SweepDelaunay seam(seamPoints);
+    const auto& seamTriangles = seam.getTriangles();
+    const auto& seamHalfEdges = seam.getHalfEdges();
+
+    auto edgeKey = [](uint32_t from, uint32_t to) { return std::pair<size_t, size_t>{ from, to }; };
+
+    std::unordered_map<std::pair<size_t, size_t>, uint32_t> seamHalfEdgeByEdge;
+    seamHalfEdgeByEdge.reserve(seamTriangles.size());
+    for (uint32_t h = 0; h < seamTriangles.size(); h++)
+        seamHalfEdgeByEdge[edgeKey(seamVertices[seamTriangles[h]], seamVertices[seamTriangles[h - h % 3 + (h + 1) % 3]])] = h;
+
+    /* Assembling final triangles, each strip on its own thread */
+
+    // Global index of the first final half-edge of each strip
+    std::vector<uint32_t> stripOffsets(stripCount + 1, 0);
+    for (size_t k = 0; k < stripCount; k++)
+        stripOffsets[k + 1] = stripOffsets[k] + strips[k].finalHalfEdgeCount;
+
+    std::vector<uint32_t> triangles(stripOffsets.back());
+    std::vector<uint32_t> halfEdges(stripOffsets.back(), Invalid);
+
+    runInParallel([&](size_t k)
+    {
+        Strip& strip = strips[k];
+        const uint32_t offset = stripOffsets[k];
+
+        for (size_t h = 0; h < strip.triangles.size(); h++)
+        {
+            if (!strip.isFinal[h / 3])
+                continue;
+
+            const uint32_t gh = offset + strip.finalFirstHalfEdge[h / 3] + static_cast<uint32_t>(h % 3);
+            const uint32_t twin = strip.halfEdges[h];
+
+            triangles[gh] = strip.triangles[h];
+
+            if (twin != Invalid && strip.isFinal[twin / 3])
+            {
+                halfEdges[gh] = offset + strip.finalFirstHalfEdge[twin / 3] + twin % 3;
+                continue;
+            }
+
+            const uint32_t from = strip.triangles[h];
+            const uint32_t to = strip.triangles[h - h % 3 + (h + 1) % 3];
+
+            // No opposite half-edge in the seam triangulation: this is an edge of the convex hull
+            if (auto it = seamHalfEdgeByEdge.find(edgeKey(to, from)); it != seamHalfEdgeByEdge.end())
+                strip.seamBoundary.emplace_back(gh, it->second);
+        }
+    });
+
+    // Seam half-edges facing a final triangle: they bound the area left to the seam triangulation
+    std::vector<bool> isSeamBoundary(seamTriangles.size(), false);
+    std::vector<uint32_t> boundaryFinalHalfEdge(seamTriangles.size(), Invalid);
+
+    for (const auto& strip : strips)
+    {
+        for (const auto& [gh, h] : strip.seamBoundary)
+        {
+            isSeamBoundary[h] = true;
+            boundaryFinalHalfEdge[h] = gh;
+        }
+    }
+
+    // Flood filling the seam triangulation from the boundary, without crossing it
+    std::vector<bool> isSeamKept(seamTriangles.size() / 3, false);
+    std::vector<uint32_t> stack;
+
+    for (uint32_t h = 0; h < seamTriangles.size(); h++)
+        if (isSeamBoundary[h])
+            stack.push_back(h / 3);
+
+    // Without any final triangle, the seam triangulation is the whole triangulation
+    if (stack.empty())
+        for (uint32_t t = 0; t < seamTriangles.size() / 3; t++)
+            stack.push_back(t);
+
+    while (!stack.empty())
+    {
+        const uint32_t t = stack.back();
+        stack.pop_back();
+
+        if (isSeamKept[t])
+            continue;
+        isSeamKept[t] = true;
+
+        for (uint32_t h = 3 * t; h < 3 * t + 3; h++)
+            if (!isSeamBoundary[h] && seamHalfEdges[h] != Invalid)
+                stack.push_back(seamHalfEdges[h] / 3);
+    }
+
+    std::vector<uint32_t> seamFirstHalfEdge(seamTriangles.size() / 3, Invalid);
+    triangles.reserve(triangles.size() + seamTriangles.size());
+    for (uint32_t t = 0; t < seamTriangles.size() / 3; t++)
+    {
+        if (!isSeamKept[t])
+            continue;
+
+        seamFirstHalfEdge[t] = static_cast<uint32_t>(triangles.size());
+        for (uint32_t j = 0; j < 3; j++)
+            triangles.push_back(seamVertices[seamTriangles[3 * t + j]]);
+    }
+
+    halfEdges.resize(triangles.size(), Invalid);
+
+    for (uint32_t h = 0; h < seamTriangles.size(); h++)
+    {
+        const uint32_t global = seamFirstHalfEdge[h / 3];
+        if (global == Invalid)
+            continue;
+
+        const uint32_t gh = global + h % 3;
+
+        if (isSeamBoundary[h])
+        {
+            halfEdges[gh] = boundaryFinalHalfEdge[h];
+            halfEdges[boundaryFinalHalfEdge[h]] = gh;
+        }
+        else if (const uint32_t twin = seamHalfEdges[h]; twin != Invalid && isSeamKept[twin / 3])
+            halfEdges[gh] = seamFirstHalfEdge[twin / 3] + twin % 3;
+    }
+
+    setTriangulation(points, triangles, halfEdges, stripCount);
+}
+
+void TriangularMesh::setTriangulation(std::span<const glm::vec3> points, const std::vector<uint32_t>& triangles, const std::vector<uint32_t>& halfEdges,
+                                      size_t threadCount)
+{
+    clear();
+
+    const Index finiteFaceCount = static_cast<Index>(triangles.size() / 3);
+    threadCount = std::max<size_t>(1, std::min<size_t>(threadCount, finiteFaceCount / 1024 + 1));
+
+    auto runInParallel = [threadCount](size_t count, const auto& work)
+    {
+        std::vector<std::thread> threads;
+        const size_t step = count / threadCount;
+
+        for (size_t t = 0; t < threadCount; t++)
+            threads.emplace_back(work, t, t * step, (t == threadCount - 1) ? count : (t + 1) * step);
+
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    // Duplicates skipped by the triangulation are in no face: they stay free, but keep their index and are not
+    // reused, so that vertex indices still match the points
+    m_Vertices.reserve(points.size() + 1);
+    for (const auto& p : points)
+        addVertex(Vertex{ p, InvalidIndex });
+
+    m_InfiniteVertexIndex = addVertex(Vertex{ { 0.f, -10000000.f, 0.f }, finiteFaceCount });
+    m_IsForTriangulation = true;
+
+    // Finite faces. Half-edge 3t+k goes from vertex k to vertex k+1, so it is opposite to vertex k+2.
+    m_Faces.resize(finiteFaceCount);
+    std::vector<std::vector<size_t>> threadHullHalfEdges(threadCount);
+
+    runInParallel(finiteFaceCount, [this, &triangles, &halfEdges, &threadHullHalfEdges](size_t thread, size_t start, size_t end)
+    {
+        for (size_t t = start; t < end; t++)
+        {
+            Face& f = m_Faces.at(t);
+
+            for (glm::length_t k = 0; k < 3; k++)
+            {
+                const size_t h = 3 * t + k;
+                f.indices[k] = triangles[h];
+
+                if (halfEdges[h] == SweepDelaunay::Invalid)
+                    threadHullHalfEdges[thread].push_back(h);
+                else
+                {
+                    f.neighbours[(k + 2) % 3] = halfEdges[h] / 3;
+                    f.setOppositeLocal((k + 2) % 3, (halfEdges[h] % 3 + 2) % 3);
+                }
+            }
+        }
+    });
+
+    // Each vertex keeps its last face, whatever the thread count
+    for (size_t h = 0; h < triangles.size(); h++)
+        m_Vertices[triangles[h]].faceIndex = h / 3;
+
+    // Infinite faces, one per hull edge. Each one is indexed by the first and the last vertex of its hull edge.
+    std::unordered_map<Index, size_t> infiniteFaceFrom;
+    std::unordered_map<Index, size_t> infiniteFaceTo;
+
+    for (const auto& hullHalfEdges : threadHullHalfEdges)
+    {
+        for (size_t h : hullHalfEdges)
+        {
+            const size_t t = h / 3;
+            const glm::length_t k = static_cast<glm::length_t>(h % 3);
+            const size_t iF = m_Faces.size();
+
+            Face& f = m_Faces.emplace_back();
+            f.i0 = m_InfiniteVertexIndex;
+            f.i1 = triangles[3 * t + (k + 1) % 3];
+            f.i2 = triangles[h];
+
+            linkFaces(iF, 0, t, (k + 2) % 3);
+
+            infiniteFaceFrom[f.i2] = iF;
+            infiniteFaceTo[f.i1] = iF;
+        }
+    }
+
+    for (size_t iF = finiteFaceCount; iF < m_Faces.size(); iF++)
+    {
+        Face& f = m_Faces.at(iF);
+        f.n1 = infiniteFaceTo.at(f.i2);
+        f.n2 = infiniteFaceFrom.at(f.i1);
+        f.setOppositeLocal(1, 2);
+        f.setOppositeLocal(2, 1);
+    }
+
+    buildHierarchy();
+}
+
+int TriangularMesh::insertPoints(std::span<const glm::vec3> points, InsertionKernel kernel)
+{
+    VRM_ASSERT_MSG(m_IsForTriangulation, "Points can only be inserted in a triangulation.");
+
+    const size_t firstVertexIndex = m_Vertices.size();
+    size_t hintFaceIndex = m_Vertices.back().faceIndex;
+
+    m_Vertices.reserve(m_Vertices.size() + points.size());
+    m_Faces.reserve(m_Faces.size() + 2 * points.size());
+
+    for (const auto& p : points)
+        addVertex(Vertex{ p, 0 });
+
+    int flipsCount = 0;
+
+    // Each location walk starts from the previously inserted vertex, which is close thanks to the spatial order
+    for (size_t i : SpatialSort::BRIO(points))
+    {
+        const size_t vertexIndex = firstVertexIndex + i;
+        flipsCount += insertVertex_StreamingDelaunayTriangulation(vertexIndex, hintFaceIndex, kernel);
+        if (!isVertexFree(vertexIndex))
+            hintFaceIndex = m_Vertices.at(vertexIndex).faceIndex;
+    }
+
+    buildHierarchy();
+
+    return flipsCount;
+}
+
+int TriangularMesh::insertVertex_StreamingDelaunayTriangulation(size_t vertexIndex, size_t hintFaceIndex, InsertionKernel kernel)
+{
+    if (kernel == InsertionKernel::BOWYER_WATSON)
+        return insertVertex_BowyerWatson(vertexIndex, hintFaceIndex);
+
+    insertVertex_StreamingTriangulation(vertexIndex, hintFaceIndex);
+
+    if (isVertexFree(vertexIndex))
+        return 0;
+
+    return legalizeVertex(vertexIndex);
+}
+
+int TriangularMesh::legalizeVertex(size_t vertexIndex)
+{
+    // Edges to check: the ones opposite to the new vertex
+    m_EdgeStack.clear();
+
+    for (auto it = begin_turning_faces(vertexIndex); it != end_turning_faces(vertexIndex); ++it)
+        m_EdgeStack.push_back(Corner{ static_cast<Index>(*it), it.localVertexIndex() });
+
+    return delaunayAlgorithm(m_EdgeStack);
+}
+
+int TriangularMesh::insertVertex_BowyerWatson(size_t vertexIndex, size_t hintFaceIndex)
+{
+    const glm::vec3 point = m_Vertices.at(vertexIndex).position;
+    const Index containingFaceIndex = locateFace(point, hintFaceIndex);
+
+    // A duplicate would only be in conflict with its containing face, and make a star with a flat face
+    if (!isFaceInfinite(containingFaceIndex) && isPointAtFaceVertex(containingFaceIndex, point))
+    {
+        m_Vertices.at(vertexIndex).faceIndex = InvalidIndex;
+        return 0;
+    }
+
+    newCavityMark();
+
+    // The cavity grows from the containing face through the faces in conflict, but never across a constrained edge
+    m_CavityFaces.clear();
+    m_CavityFaces.push_back(containingFaceIndex);
+    m_CavityMarks.at(containingFaceIndex) = m_CavityMark;
+
+    for (size_t k = 0; k < m_CavityFaces.size(); k++)
+    {
+        const auto& f = m_Faces.at(m_CavityFaces[k]);
+
+        for (glm::length_t j = 0; j < 3; j++)
+        {
+            const Index neighbour = f.neighbours[j];
+
+            if (m_CavityMarks.at(neighbour) != m_CavityMark && !f.isConstrained(j) && isInConflict(neighbour, point))
+            {
+                m_CavityMarks.at(neighbour) = m_CavityMark;
+                m_CavityFaces.push_back(neighbour);
+            }
+        }
+    }
+
+    m_CavityBoundary.clear();
+
+    for (const Index face : m_CavityFaces)
+    {
+        const auto& f = m_Faces.at(face);
+
+        for (glm::length_t j = 0; j < 3; j++)
+        {
+            const bool isInside = m_CavityMarks.at(f.neighbours[j]) == m_CavityMark;
+
+            // The cavity went around a constrained edge: the flips know how to keep it
+            if (isInside && f.isConstrained(j))
+                return insertVertex_StreamingDelaunayTriangulation(vertexIndex, hintFaceIndex, InsertionKernel::FLIPS);
+
+            if (!isInside)
+                m_CavityBoundary.push_back(HoleEdge{
+                    .from = f.indices[(j + 1) % 3],
+                    .to = f.indices[(j + 2) % 3],
+                    .outside = Corner{ f.neighbours[j], f.oppositeLocal(j) },
+                    .constrained = f.isConstrained(j)
+                });
+        }
+    }
+
+    // A cavity which is not a disk with all its vertices on its boundary cannot be triangulated as a star
+    if (m_CavityBoundary.size() != m_CavityFaces.size() + 2)
+        return insertVertex_StreamingDelaunayTriangulation(vertexIndex, hintFaceIndex, InsertionKernel::FLIPS);
+
+    // Faces of the star: (vertex, from, to) for each boundary edge, in the cavity faces and two new ones
+    m_CavityStarFaces.clear();
+
+    for (size_t k = 0; k < m_CavityBoundary.size(); k++)
+    {
+        const HoleEdge& edge = m_CavityBoundary[k];
+        const Index face = k < m_CavityFaces.size() ? m_CavityFaces[k] : newFace();
+
+        Face& f = m_Faces.at(face);
+        f = Face();
+        f.i0 = static_cast<Index>(vertexIndex);
+        f.i1 = edge.from;
+        f.i2 = edge.to;
+        f.setConstrained(0, edge.constrained);
+        linkFaces(face, 0, edge.outside.face, edge.outside.local);
+
+        m_Vertices.at(edge.from).faceIndex = face;
+        m_CavityStarFaces.emplace_back(edge.from, face);
+    }
+
+    m_Vertices.at(vertexIndex).faceIndex = m_CavityStarFaces.front().second;
+
+    // Around the vertex, the face starting at "to" follows the face (vertex, from, to)
+    std::sort(m_CavityStarFaces.begin(), m_CavityStarFaces.end());
+
+    for (const auto& [from, face] : m_CavityStarFaces)
+    {
+        const Index to = m_Faces.at(face).i2;
+        const Index nextFace = std::lower_bound(m_CavityStarFaces.begin(), m_CavityStarFaces.end(), std::make_pair(to, Index(0)))->second;
+
+        linkFaces(face, 1, nextFace, 2);
+    }
+
+    return static_cast<int>(m_CavityFaces.size()) - 1;
+}
+
+bool TriangularMesh::isInConflict(size_t faceIndex, const glm::vec3& point) const
+{
+    const auto& f = m_Faces.at(faceIndex);
+    const glm::dvec2 p = glm::dvec2(point.x, -point.z);
+
+    if (!isFaceInfinite(faceIndex))
+        return Predicates::InCircle(planePosition(f.i0), planePosition(f.i1), planePosition(f.i2), p) > 0.0;
+
+    const glm::length_t iInfVertex_local = localVertexIndex(m_InfiniteVertexIndex, faceIndex);
+    const glm::dvec2 a = planePosition(f.indices[(iInfVertex_local + 1) % 3]);
+    const glm::dvec2 b = planePosition(f.indices[(iInfVertex_local + 2) % 3]);
+    const double orientation = Predicates::Orient2D(a, b, p);
+
+    return orientation > 0.0 || (orientation == 0.0 && glm::dot(a - p, b - p) < 0.0);
+}
+
+int TriangularMesh::refine(float minAngle, float maxArea, size_t maxSteinerPoints)
+{
+    VRM_ASSERT_MSG(m_IsForTriangulation, "Only triangulations can be refined.");
+
+    if (minAngle > 20.7f)
+        VRM_LOG_WARN("Refinement may not terminate with a minimum angle of {} degrees.", minAngle);
+
+    // The smallest angle of a triangle is asin(shortest edge / (2 * circumradius))
+    const double maxRadiusEdgeRatio = 1.0 / (2.0 * std::sin(glm::radians(static_cast<double>(minAngle))));
+
+    struct BadFace
+    {
+        double priority;
+        Index face;
+        // To skip the faces that changed since they were pushed
+        glm::vec<3, Index> indices;
+
+        bool operator<(const BadFace& other) const { return priority < other.priority; }
+    };
+
+    std::priority_queue<BadFace> badFaces;
+
+    // Segments encroached upon by a vertex, which are split before any bad face. They are kept by their vertices,
+    // since their faces change with the insertions around them.
+    std::vector<std::pair<Index, Index>> encroachedSegments;
+
+    auto pushIfBad = [this, &badFaces, maxRadiusEdgeRatio, maxArea](size_t faceIndex)
+    {
+        if (isFaceInfinite(faceIndex))
+            return;
+
+        if (const double priority = refinementPriority(faceIndex, maxRadiusEdgeRatio, maxArea); priority > 1.0)
+            badFaces.push(BadFace{ priority, static_cast<Index>(faceIndex), m_Faces.at(faceIndex).indices });
+    };
+
+    // In a constrained Delaunay triangulation, the vertices facing a segment are enough to know if it is encroached upon
+    auto pushIfEncroached = [this, &encroachedSegments](size_t faceIndex, glm::length_t local)
+    {
+        if (!isSegment(faceIndex, local))
+            return;
+
+        const auto& f = m_Faces.at(faceIndex);
+        const Index opposite[2] = { f.indices[local], m_Faces.at(f.neighbours[local]).indices[f.oppositeLocal(local)] };
+
+        for (const Index v : opposite)
+        {
+            if (v != m_InfiniteVertexIndex && isEdgeEncroached(faceIndex, local, m_Vertices.at(v).position))
+            {
+                encroachedSegments.emplace_back(f.indices[(local + 1) % 3], f.indices[(local + 2) % 3]);
+                return;
+            }
+        }
+    };
+
+    auto findEdge = [this](Index from, Index to) -> std::optional<Corner>
+    {
+        for (auto it = begin_turning_faces(from); it != end_turning_faces(from); ++it)
+            if (m_Faces.at(*it).indices[(it.localVertexIndex() + 1) % 3] == to)
+                return Corner{ static_cast<Index>(*it), (it.localVertexIndex() + 2) % 3 };
+
+        return std::nullopt;
+    };
+
+    for (size_t i = 0; i < m_Faces.size(); i++)
+    {
+        if (isFaceFree(i))
+            continue;
+
+        pushIfBad(i);
+        for (glm::length_t j = 0; j < 3; j++)
+            pushIfEncroached(i, j);
+    }
+
+    size_t steinerPointsCount = 0;
+
+    while (steinerPointsCount < maxSteinerPoints)
+    {
+        std::optional<BadFace> badFace;
+        Index vertexIndex = InvalidIndex;
+
+        if (!encroachedSegments.empty())
+        {
+            const auto [from, to] = encroachedSegments.back();
+            encroachedSegments.pop_back();
+
+            // Already split
+            const std::optional<Corner> segment = findEdge(from, to);
+            if (!segment.has_value())
+                continue;
+
+            vertexIndex = splitSegment(segment->face, segment->local);
+        }
+        else if (!badFaces.empty())
+        {
+            badFace = badFaces.top();
+            badFaces.pop();
+
+            if (m_Faces.at(badFace->face).indices != badFace->indices)
+                continue;
+
+            vertexIndex = insertSteinerPoint(badFace->face);
+        }
+        else
+            break;
+
+        if (vertexIndex == InvalidIndex)
+            continue;
+
+        legalizeVertex(vertexIndex);
+        ++steinerPointsCount;
+
+        // Insertion and flips only changed the faces around the new vertex
+        for (auto it = begin_turning_faces(vertexIndex); it != end_turning_faces(vertexIndex); ++it)
+        {
+            pushIfBad(*it);
+            for (glm::length_t j = 0; j < 3; j++)
+                pushIfEncroached(*it, j);
+        }
+
+        // Splitting a segment may leave the face as it was
+        if (badFace.has_value() && m_Faces.at(badFace->face).indices == badFace->indices)
+            badFaces.push(*badFace);
+    }
+
+    if (steinerPointsCount == maxSteinerPoints)
+        VRM_LOG_WARN("Refinement stopped after {} Steiner points.", steinerPointsCount);
+
+    return static_cast<int>(steinerPointsCount);
+}
+
+double TriangularMesh::refinementPriority(size_t faceIndex, double maxRadiusEdgeRatio, double maxArea) const
+{
+    const auto& f = m_Faces.at(faceIndex);
+    const glm::dvec2 p0 = planePosition(f.i0);
+    const glm::dvec2 p1 = planePosition(f.i1);
+    const glm::dvec2 p2 = planePosition(f.i2);
+
+    const double doubleArea = Predicates::Orient2D(p0, p1, p2);
+
+    // Flat faces cannot be refined
+    if (doubleArea <= 0.0)
+        return 0.0;
+
+    const double l0 = glm::distance(p1, p2);
+    const double l1 = glm::distance(p2, p0);
+    const double l2 = glm::distance(p0, p1);
+    const double circumradius = l0 * l1 * l2 / (2.0 * doubleArea);
+
+    return std::max(circumradius / std::min({ l0, l1, l2 }) / maxRadiusEdgeRatio, doubleArea / (2.0 * maxArea));
+}
+
+glm::dvec2 TriangularMesh::circumcenter(size_t faceIndex) const
+{
+    const auto& f = m_Faces.at(faceIndex);
+    const glm::dvec2 p0 = planePosition(f.i0);
+    const glm::dvec2 b = planePosition(f.i1) - p0;
+    const glm::dvec2 c = planePosition(f.i2) - p0;
+
+    // Computed relatively to p0, for precision
+    const double denominator = 2.0 * (b.x * c.y - b.y * c.x);
+    return p0 + glm::dvec2(c.y * glm::dot(b, b) - b.y * glm::dot(c, c), b.x * glm::dot(c, c) - c.x * glm::dot(b, b)) / denominator;
+}
+
+TriangularMesh::Index TriangularMesh::insertSteinerPoint(size_t faceIndex)
+{
+    // Circumcenter, rounded to the precision of the vertex positions
+    const glm::dvec2 center = glm::dvec2(glm::vec2(circumcenter(faceIndex)));
+    const glm::vec3 point(center.x, 0.f, -center.y);
+
+    std::optional<Corner> blockingConstraint;
+    const Index containingFaceIndex = locateFace(point, faceIndex, &blockingConstraint);
+
+    // Hidden behind a constrained edge, outside of the hull, or next to a segment it encroaches upon
+    std::optional<Corner> segment = blockingConstraint;
+
+    if (!segment.has_value() && isFaceInfinite(containingFaceIndex))
+        segment = Corner{ containingFaceIndex, localVertexIndex(m_InfiniteVertexIndex, containingFaceIndex) };
+
+    if (!segment.has_value())
+        segment = findEncroachedSegment(containingFaceIndex, point);
+
+    // Only a segment the circumcenter encroaches upon is split. A circumcenter beyond a segment without being in its
+    // diametral circle comes from a face next to a segment that could not be split, which is left as it is.
+    if (segment.has_value())
     {
-        if (*it == faceIndex)
-            return true;
+        if (!isEdgeEncroached(segment->face, segment->local, point))
+            return InvalidIndex;
+
+        return splitSegment(segment->face, segment->local);
     }
 
-    return false;
-}
+    const auto& h = m_Faces.at(containingFaceIndex);
 
-std::optional<size_t> TriangularMesh::getFaceContainingPoint(const glm::vec3& vertexPosition) const
-{
-    glm::vec2 p = glm::vec2(vertexPosition.x, -vertexPosition.z);
+    // Barycentric coordinates, to interpolate the height
+    const glm::dvec2 q0 = planePosition(h.i0);
+    const glm::dvec2 q1 = planePosition(h.i1);
+    const glm::dvec2 q2 = planePosition(h.i2);
+    const glm::dvec3 weights(Predicates::Orient2D(q1, q2, center), Predicates::Orient2D(q2, q0, center), Predicates::Orient2D(q0, q1, center));
+    const glm::dvec3 heights(m_Vertices.at(h.i0).position.y, m_Vertices.at(h.i1).position.y, m_Vertices.at(h.i2).position.y);
+    const glm::vec3 position(center.x, glm::dot(weights, heights) / (weights.x + weights.y + weights.z), -center.y);
 
-    for (size_t f_i = 0; f_i < m_Faces.size(); f_i++)
-    {
-        if (isFaceInfinite(f_i))
-            continue;
-            
-        const auto& f = m_Faces.at(f_i);
-        bool inside = true;
+    const int zeroWeightsCount = (weights.x == 0.0) + (weights.y == 0.0) + (weights.z == 0.0);
 
-        for (glm::length_t i = 0; i < 3; i++)
-        {
-            const glm::length_t i_next = (i + 1) % 3;
-            const auto& v_i = m_Vertices.at(f.indices[i]);
-            const auto& v_i_next = m_Vertices.at(f.indices[i_next]);
-            const glm::vec2 v_i_2D = glm::vec2(v_i.position.x, -v_i.position.z);
-            const glm::vec2 v_i_next_2D = glm::vec2(v_i_next.position.x, -v_i_next.position.z);
-            
-            const auto det = glm::determinant(glm::mat2(p - v_i_2D, v_i_next_2D - v_i_2D));
+    if (zeroWeightsCount > 1)
+        return InvalidIndex;
 
-            if (det > 0.f)
-            {
-                inside = false;
-                break;
-            }
-        }
+    const Index vertexIndex = newVertex(Vertex{ position, 0 });
 
-        if (inside)
-            return f_i;
+    // On an edge, like the circumcenter of a right triangle
+    for (glm::length_t j = 0; j < 3; j++)
+    {
+        if (weights[j] == 0.0)
+        {
+            edgeSplit(containingFaceIndex, j, vertexIndex);
+            return vertexIndex;
+        }
     }
 
-    return std::nullopt;
+    faceSplit(containingFaceIndex, vertexIndex);
+
+    return vertexIndex;
 }
 
-bool TriangularMesh::canPointSeeEdge(const glm::vec3& point, size_t vertexIndex0, size_t vertexIndex1) const
+bool TriangularMesh::isSegment(size_t faceIndex, glm::length_t localEdgeIndex) const
 {
-    const auto& v0 = m_Vertices.at(vertexIndex0).position;
-    const auto& v1 = m_Vertices.at(vertexIndex1).position;
+    const auto& f = m_Faces.at(faceIndex);
+    return f.isConstrained(localEdgeIndex) || isFaceInfinite(faceIndex) != isFaceInfinite(f.neighbours[localEdgeIndex]);
+}
 
-    const glm::vec2 A = glm::vec2(v0.x, -v0.z);
-    const glm::vec2 B = glm::vec2(v1.x, -v1.z);
-    const glm::vec2 P = glm::vec2(point.x, -point.z);
+bool TriangularMesh::isEdgeEncroached(size_t faceIndex, glm::length_t localEdgeIndex, const glm::vec3& point) const
+{
+    const auto& f = m_Faces.at(faceIndex);
+    const glm::dvec2 p(point.x, -point.z);
 
-    return glm::determinant(glm::mat2(P - A, B - A)) > 0.f;
+    // The edge is seen from the point with an obtuse angle
+    return glm::dot(planePosition(f.indices[(localEdgeIndex + 1) % 3]) - p, planePosition(f.indices[(localEdgeIndex + 2) % 3]) - p) < 0.0;
 }
 
-size_t TriangularMesh::addVertex_StreamingTriangulation(const glm::vec3& vertexPosition)
+std::optional<TriangularMesh::Corner> TriangularMesh::findEncroachedSegment(size_t faceIndex, const glm::vec3& point)
 {
-    if (auto containingFaceID = getFaceContainingPoint(vertexPosition); containingFaceID.has_value())
-    {
-        faceSplit(containingFaceID.value(), vertexPosition);
-        return m_Vertices.size() - 1;
-    }
+    newCavityMark();
 
-    // If we couldn't find any face containing the point, we will need to add geometry outside convex hull
+    m_CavityFaces.assign(1, static_cast<Index>(faceIndex));
+    m_CavityMarks.at(faceIndex) = m_CavityMark;
 
-    bool foundFirst = false;
-    auto first = end_turning_faces(m_InfiniteVertexIndex);
-    auto last = end_turning_faces(m_InfiniteVertexIndex);
-    
-    for (auto it = begin_turning_faces(m_InfiniteVertexIndex); it != end_turning_faces(m_InfiniteVertexIndex); ++it)
+    for (size_t k = 0; k < m_CavityFaces.size(); k++)
     {
-        const auto& f = m_Faces.at(*it);
-        auto iInfVertex_local = localVertexIndex(m_InfiniteVertexIndex, *it);
-        
-        if (canPointSeeEdge(vertexPosition, f.indices[(iInfVertex_local + 2) % 3], f.indices[(iInfVertex_local + 1) % 3]))
+        const Index face = m_CavityFaces[k];
+
+        for (glm::length_t j = 0; j < 3; j++)
         {
-            if (!foundFirst)
+            const Index neighbour = m_Faces.at(face).neighbours[j];
+
+            if (isSegment(face, j))
             {
-                foundFirst = true;
-                first = it;
+                if (isEdgeEncroached(face, j, point))
+                    return Corner{ face, j };
+            }
+            else if (m_CavityMarks.at(neighbour) != m_CavityMark && isInConflict(neighbour, point))
+            {
+                m_CavityMarks.at(neighbour) = m_CavityMark;
+                m_CavityFaces.push_back(neighbour);
             }
-
-            last = it;
         }
-        else if (foundFirst)
-            break;
     }
 
-    // Now we make sure the first we found is really the first
-    // When iterating, if we started on an edge that is visible by the new point,
-    // we need to check if we can see more edges going clockwise.
+    return std::nullopt;
+}
 
-    for (auto it = first; ;)
+namespace
+{
+    // Solutions k of a k = b (mod 2^n), as k = r (mod 2^m) returned as (r, m), if there are some
+    std::optional<std::pair<uint64_t, int>> SolveCongruence(int64_t a, int64_t b, int n)
     {
-        --it;
-        const auto& f = m_Faces.at(*it);
-        auto iInfVertex_local = localVertexIndex(m_InfiniteVertexIndex, *it);
+        const uint64_t mask = (uint64_t(1) << n) - 1;
+        const uint64_t ua = static_cast<uint64_t>(a) & mask;
+        const uint64_t ub = static_cast<uint64_t>(b) & mask;
 
-        if (canPointSeeEdge(vertexPosition, f.indices[(iInfVertex_local + 2) % 3], f.indices[(iInfVertex_local + 1) % 3]))
-        {
-            first = it;
-        }
-        else
-            break;
+        if (ua == 0)
+            return ub == 0 ? std::optional(std::pair<uint64_t, int>(0, 0)) : std::nullopt;
+
+        const int t = std::countr_zero(ua);
+        if ((ub & ((uint64_t(1) << t) - 1)) != 0)
+            return std::nullopt;
+
+        // Inverse of the odd part modulo 2^64, each Newton iteration doubles its correct bits
+        const uint64_t odd = ua >> t;
+        uint64_t inverse = odd;
+        for (int i = 0; i < 5; i++)
+            inverse *= 2 - odd * inverse;
+
+        return std::pair<uint64_t, int>(((ub >> t) * inverse) & ((uint64_t(1) << (n - t)) - 1), n - t);
     }
+}
+
+std::optional<glm::vec3> TriangularMesh::segmentSplitPoint(size_t vertexIndex0, size_t vertexIndex1) const
+{
+    const glm::vec3& p0 = m_Vertices.at(vertexIndex0).position;
+    const glm::vec3& p1 = m_Vertices.at(vertexIndex1).position;
+
+    // Segments are not split below 64 times the float spacing of their coordinates
+    const float magnitude = std::max({ std::abs(p0.x), std::abs(p0.z), std::abs(p1.x), std::abs(p1.z) });
+    if (glm::distance(glm::dvec2(p0.x, p0.z), glm::dvec2(p1.x, p1.z)) < 64.0 * std::numeric_limits<float>::epsilon() * magnitude)
+        return std::nullopt;
+
+    // The plane coordinates are integers in units of the finest float spacing among them. The points of the segment
+    // with integer coordinates are p0 + k (p1 - p0) / g for k in [0, g], with g the gcd of the differences.
+    int unitExponent = std::numeric_limits<int>::max();
+    for (const float c : { p0.x, p0.z, p1.x, p1.z })
+        if (c != 0.f)
+            unitExponent = std::min(unitExponent, std::ilogb(c) - std::numeric_limits<float>::digits + 1);
+
+    const double x0 = std::ldexp(static_cast<double>(p0.x), -unitExponent);
+    const double z0 = std::ldexp(static_cast<double>(p0.z), -unitExponent);
+    const double dx = std::ldexp(static_cast<double>(p1.x), -unitExponent) - x0;
+    const double dz = std::ldexp(static_cast<double>(p1.z), -unitExponent) - z0;
+
+    // Too far apart in magnitude to be counted in units
+    if (!(std::max({ std::abs(x0), std::abs(z0), std::abs(dx), std::abs(dz) }) < 0x1p52))
+        return std::nullopt;
+
+    const int64_t g = std::gcd(static_cast<int64_t>(dx), static_cast<int64_t>(dz));
+    if (g < 2)
+        return std::nullopt;
+
+    const int64_t sx = static_cast<int64_t>(dx) / g;
+    const int64_t sz = static_cast<int64_t>(dz) / g;
+
+    // Away from zero, floats are only multiples of 2^e units: the middle half of the segment needs e at its largest
+    // coordinate, and k has to solve sx k = -x0 (mod 2^e), and the same in z
+    auto spacingExponent = [](double c0, double c) {
+        const double largest = std::max(std::abs(c0 + c / 4.0), std::abs(c0 + 3.0 * c / 4.0));
+        return largest < 1.0 ? 0 : std::max(0, std::ilogb(largest) - std::numeric_limits<float>::digits + 1);
+    };
 
-    // Keeping track of current and next faces because we are changing geometry:
-    auto currentFace = first;
-    auto nextFace = std::next(first, 1);
+    const auto kx = SolveCongruence(sx, -static_cast<int64_t>(x0), spacingExponent(x0, dx));
+    const auto kz = SolveCongruence(sz, -static_cast<int64_t>(z0), spacingExponent(z0, dz));
 
-    // Now we can add the new point.
-    // For the first one, we only split the face:
-    faceSplit(*currentFace, vertexPosition);
+    if (!kx.has_value() || !kz.has_value())
+        return std::nullopt;
 
-    if (*first == *last)
-        return m_Vertices.size() - 1;
+    // Both at once: the solutions with the finer period have to agree with the others
+    const auto [r, m] = kx->second >= kz->second ? *kx : *kz;
+    const auto [otherR, otherM] = kx->second >= kz->second ? *kz : *kx;
 
-    currentFace = nextFace;
-    ++nextFace;
+    if (((r ^ otherR) & ((uint64_t(1) << otherM) - 1)) != 0)
+        return std::nullopt;
 
-    // For the other ones, we will flip an infinite edge:
-    for (;;)
+    // The solution closest to the middle, then its neighbours, within the middle half of the segment
+    const int64_t period = int64_t(1) << m;
+    const int64_t offset = g / 2 - static_cast<int64_t>(r) + period / 2;
+    const int64_t middle = static_cast<int64_t>(r) + (offset >= 0 ? offset / period : -((-offset + period - 1) / period)) * period;
+
+    for (const int64_t k : { middle, middle - period, middle + period })
     {
-        auto& f = m_Faces.at(*currentFace);
-        auto iInfVertex_local = localVertexIndex(m_InfiniteVertexIndex, *currentFace);
-        edgeFlip(
-            f.indices[(iInfVertex_local + 0) % 3],
-            f.indices[(iInfVertex_local + 1) % 3]
-        );
+        if (4 * k < g || 4 * k > 3 * g)
+            continue;
 
-        if (*currentFace == *last)
-            break;
+        const double x = std::ldexp(static_cast<double>(static_cast<int64_t>(x0) + k * sx), unitExponent);
+        const double z = std::ldexp(static_cast<double>(static_cast<int64_t>(z0) + k * sz), unitExponent);
 
-        currentFace = nextFace;
-        ++nextFace;
+        if (static_cast<float>(x) == x && static_cast<float>(z) == z)
+            return glm::vec3(x, p0.y + (p1.y - p0.y) * static_cast<float>(static_cast<double>(k) / static_cast<double>(g)), z);
     }
 
-    return m_Vertices.size() - 1;
+    return std::nullopt;
 }
 
-bool TriangularMesh::isEdgeDelaunay(const Edge& edge) const
+TriangularMesh::Index TriangularMesh::splitSegment(size_t faceIndex, glm::length_t localEdgeIndex)
 {
-    // Paraboloid method
-    const auto& t0 = m_Faces.at(edge.t0);
-    const auto& t1 = m_Faces.at(edge.t1);
-    auto A = m_Vertices.at(edge.e1).position;
-    auto B = m_Vertices.at(edge.e0).position;
-    auto C = m_Vertices.at(t0.indices[(localVertexIndex(edge.e0, edge.t0) + 1) % 3]).position;
-    auto D = m_Vertices.at(t1.indices[(localVertexIndex(edge.e1, edge.t1) + 1) % 3]).position;
+    const auto& f = m_Faces.at(faceIndex);
+    const std::optional<glm::vec3> position = segmentSplitPoint(f.indices[(localEdgeIndex + 1) % 3], f.indices[(localEdgeIndex + 2) % 3]);
+
+    if (!position.has_value())
+        return InvalidIndex;
 
-    // Lifting triangle t0 on the paraboloid
-    A.y = std::powf(A.x, 2.f) + std::powf(A.z, 2.f);
-    A.z = -A.z;
-    B.y = std::powf(B.x, 2.f) + std::powf(B.z, 2.f);
-    B.z = -B.z;
-    C.y = std::powf(C.x, 2.f) + std::powf(C.z, 2.f);
-    C.z = -C.z;
-    D.y = std::powf(D.x, 2.f) + std::powf(D.z, 2.f);
-    D.z = -D.z;
+    const Index vertexIndex = newVertex(Vertex{ *position, 0 });
+    edgeSplit(faceIndex, localEdgeIndex, vertexIndex);
+
+    return vertexIndex;
+}
 
-    // D has to be under the plane (ABC) to be inside the circonscribed triangle
-    return glm::determinant(glm::mat3(B - A, C - A, D - A)) < 0.f;
+void TriangularMesh::newCavityMark()
+{
+    // Faces are marked as part of the cavity with a new number each time, so that marks never need to be cleared
+    if (++m_CavityMark == 0)
+    {
+        std::fill(m_CavityMarks.begin(), m_CavityMarks.end(), 0);
+        m_CavityMark = 1;
+    }
+    m_CavityMarks.resize(m_Faces.size(), 0);
 }
 
-int TriangularMesh::addVertex_StreamingDelaunayTriangulation(const glm::vec3& vertexPosition)
+TriangularMesh::VoronoiDiagram TriangularMesh::computeVoronoiDiagram(const glm::vec2& boxMin, const glm::vec2& boxMax, size_t threadCount) const
 {
-    size_t vertexIndex = addVertex_StreamingTriangulation(vertexPosition);
+    VRM_ASSERT_MSG(m_IsForTriangulation, "The Voronoi diagram needs the infinite vertex of a triangulation.");
 
-    // Edges to check
-    std::deque<Edge> checkList;
+    VoronoiDiagram diagram;
+    threadCount = std::max<size_t>(threadCount, 1);
 
-    for (auto it = begin_turning_faces(vertexIndex); it != end_turning_faces(vertexIndex); ++it)
+    auto runInParallel = [threadCount](size_t count, const auto& work)
     {
-        if (isFaceInfinite(*it))
-            continue;
+        std::vector<std::thread> threads;
+        const size_t step = count / threadCount;
 
-        const auto& f = m_Faces.at(*it);
-        auto iv_local = localVertexIndex(vertexIndex, *it);
-        auto i_opp = f.neighbours[iv_local];
+        for (size_t t = 0; t < threadCount; t++)
+            threads.emplace_back(work, t, t * step, (t == threadCount - 1) ? count : (t + 1) * step);
 
-        if (!isFaceInfinite(i_opp))
-        {
-            Edge& e = checkList.emplace_back();
-                e.e0 = f.indices[(iv_local + 1) % 3];
-                e.e1 = f.indices[(iv_local + 2) % 3];
-                e.t0 = i_opp;
-                e.t1 = *it;
-        }
+        for (auto& thread : threads)
+            thread.join();
+    };
 
-        auto nextIt = std::next(it, 1);
+    /* Circumcenters */
 
-        if (isFaceInfinite(*nextIt))
-            continue;
+    diagram.circumcenterCount = m_Faces.size();
+    diagram.vertices.resize(m_Faces.size(), glm::vec2(0.f));
 
-        Edge& e = checkList.emplace_back();
-            e.e0 = f.indices[(iv_local + 2) % 3];
-            e.e1 = f.indices[iv_local];
-            e.t0 = *nextIt;
-            e.t1 = *it;
-    }
+    runInParallel(m_Faces.size(), [this, &diagram](size_t, size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; i++)
+        {
+            if (isFaceFree(i) || isFaceInfinite(i))
+                continue;
 
-    return delaunayAlgorithm(checkList);
-}
+            const glm::dvec2 center = circumcenter(i);
+            diagram.vertices[i] = glm::vec2(center.x, -center.y);
+        }
+    });
 
-int TriangularMesh::delaunayAlgorithm(std::deque<Edge>& checkList)
-{
-    size_t justInCase = 1'000;
-    int flipsCount = 0;
+    /* Cells */
 
-    for ( ; !checkList.empty() && justInCase != 0; --justInCase)
+    // Clipping points are indexed from circumcenterCount in each thread, then offset when merging
+    struct ThreadCells
     {
-        auto edge = checkList.front();
-        checkList.pop_front();
+        std::vector<Index> cellVertices;
+        std::vector<Index> cellNeighbours;
+        std::vector<glm::vec2> clippingPoints;
+    };
 
-        if (!isEdgeDelaunay(edge))
-        {
-            // @todo There are more edges to check, not only the edge created by the flip.
-            Edge e = edgeFlip(edge.e0, edge.e1);
+    std::vector<ThreadCells> threadCells(threadCount);
+    std::vector<Index> cellSizes(m_Vertices.size(), 0);
 
-            bool t0Inf = isFaceInfinite(e.t0);
-            bool t1Inf = isFaceInfinite(e.t1);
+    runInParallel(m_Vertices.size(), [this, &diagram, &threadCells, &cellSizes, &boxMin, &boxMax](size_t thread, size_t start, size_t end)
+    {
+        auto& cells = threadCells[thread];
 
-            if (!t0Inf)
+        // Polygon points, with their vertex index or InvalidIndex when created by the clipping, and the site across
+        // the edge starting at them or InvalidIndex on the box
+        struct PolygonPoint
+        {
+            glm::vec2 position;
+            Index vertex;
+            Index neighbour;
+        };
+        std::vector<PolygonPoint> polygon, clipped;
+        std::vector<Index> ring;
+
+        // Sutherland-Hodgman clipping, keeping the points where the signed distance is not positive. The edges along
+        // the clipping line lie across from its neighbour.
+        auto clip = [&polygon, &clipped](const auto& signedDistance, Index neighbour)
+        {
+            clipped.clear();
+            for (size_t k = 0; k < polygon.size(); k++)
             {
-                const auto& t0 = m_Faces.at(e.t0);
-                
-                glm::length_t ie00 = localVertexIndex(e.e0, e.t0);
-                glm::length_t ie10 = localVertexIndex(e.e1, e.t0);
-                
-                size_t it1p = t0.neighbours[ie10];
-                size_t it0p = t0.neighbours[ie00];
-
-                size_t iep = t0.indices[(ie00 + 1) % 3];
-
-                if (!isFaceInfinite(it1p))
-                    checkList.emplace_back(Edge{
-                        .e0 = e.e0,
-                        .e1 = iep,
-                        .t0 = it1p,
-                        .t1 = e.t0
-                    });
-
-                if (!isFaceInfinite(it0p))
-                    checkList.emplace_back(Edge{
-                        .e0 = iep,
-                        .e1 = e.e1,
-                        .t0 = it0p,
-                        .t1 = e.t0
-                    });
+                const PolygonPoint& p0 = polygon[k];
+                const PolygonPoint& p1 = polygon[(k + 1) % polygon.size()];
+                const float d0 = signedDistance(p0.position);
+                const float d1 = signedDistance(p1.position);
+
+                if (d0 <= 0.f)
+                    clipped.push_back({ p0.position, p0.vertex, d0 == 0.f && d1 > 0.f ? neighbour : p0.neighbour });
+                if ((d0 < 0.f && d1 > 0.f) || (d0 > 0.f && d1 < 0.f))
+                    clipped.push_back({ p0.position + (p1.position - p0.position) * (d0 / (d0 - d1)), InvalidIndex, d0 < 0.f ? neighbour : p0.neighbour });
             }
+            std::swap(polygon, clipped);
+        };
+
+        for (size_t v = start; v < end; v++)
+        {
+            if (isVertexFree(v) || isVertexInfinite(v))
+                continue;
 
-            if (!t1Inf)
+            // Faces around the vertex, counterclockwise
+            ring.clear();
+            bool isOnHull = false;
+            Index faceIndex = m_Vertices[v].faceIndex;
+            do
+            {
+                ring.push_back(faceIndex);
+                isOnHull |= isFaceInfinite(faceIndex);
+                faceIndex = m_Faces[faceIndex].neighbours[(localVertexIndex(v, faceIndex) + 1) % 3];
+            } while (faceIndex != m_Vertices[v].faceIndex);
+
+            polygon.clear();
+            if (isOnHull)
+            {
+                // Unbounded cell: the box, clipped by the bisectors of the edges
+                polygon.push_back({ { boxMin.x, boxMin.y }, InvalidIndex, InvalidIndex });
+                polygon.push_back({ { boxMin.x, boxMax.y }, InvalidIndex, InvalidIndex });
+                polygon.push_back({ { boxMax.x, boxMax.y }, InvalidIndex, InvalidIndex });
+                polygon.push_back({ { boxMax.x, boxMin.y }, InvalidIndex, InvalidIndex });
+
+                const glm::vec2 site(m_Vertices[v].position.x, m_Vertices[v].position.z);
+                for (const Index face : ring)
+                {
+                    const Index neighbour = m_Faces[face].indices[(localVertexIndex(v, face) + 1) % 3];
+                    if (neighbour == m_InfiniteVertexIndex)
+                        continue;
+
+                    const glm::vec2 other(m_Vertices[neighbour].position.x, m_Vertices[neighbour].position.z);
+                    clip([&site, &other](const glm::vec2& p) { return glm::dot(p - (site + other) / 2.f, other - site); }, neighbour);
+                }
+            }
+            else
             {
-                const auto& t1 = m_Faces.at(e.t1);
-
-                glm::length_t ie01 = localVertexIndex(e.e0, e.t1);
-                glm::length_t ie11 = localVertexIndex(e.e1, e.t1);
-
-                size_t it1pp = t1.neighbours[ie11];
-                size_t it0pp = t1.neighbours[ie01];
-                size_t iepp = t1.indices[(ie11  + 1) % 3];
-
-                if (!isFaceInfinite(it1pp))
-                    checkList.emplace_back(Edge{
-                        .e0 = e.e0,
-                        .e1 = iepp,
-                        .t0 = e.t1,
-                        .t1 = it1pp
-                    });
-
-                if (!isFaceInfinite(it0pp))
-                    checkList.emplace_back(Edge{
-                        .e0 = iepp,
-                        .e1 = e.e1,
-                        .t0 = e.t1,
-                        .t1 = it0pp
-                    });
+                bool isInBox = true;
+                // The edge to the circumcenter of the next face crosses the edge they share
+                for (const Index face : ring)
+                {
+                    const glm::vec2& p = diagram.vertices[face];
+                    polygon.push_back({ p, face, m_Faces[face].indices[(localVertexIndex(v, face) + 2) % 3] });
+                    isInBox &= p.x >= boxMin.x && p.x <= boxMax.x && p.y >= boxMin.y && p.y <= boxMax.y;
+                }
+
+                if (!isInBox)
+                {
+                    clip([&boxMin](const glm::vec2& p) { return boxMin.x - p.x; }, InvalidIndex);
+                    clip([&boxMax](const glm::vec2& p) { return p.x - boxMax.x; }, InvalidIndex);
+                    clip([&boxMin](const glm::vec2& p) { return boxMin.y - p.y; }, InvalidIndex);
+                    clip([&boxMax](const glm::vec2& p) { return p.y - boxMax.y; }, InvalidIndex);
+                }
             }
 
-            if (!t0Inf && !t1Inf)
-                checkList.emplace_back(e);
+            if (polygon.size() < 3)
+                continue;
 
-            ++flipsCount;
+            for (const auto& [p, index, neighbour] : polygon)
+            {
+                if (index != InvalidIndex)
+                {
+                    cells.cellVertices.push_back(index);
+                }
+                else
+                {
+                    cells.cellVertices.push_back(static_cast<Index>(diagram.circumcenterCount + cells.clippingPoints.size()));
+                    cells.clippingPoints.push_back(p);
+                }
+                cells.cellNeighbours.push_back(neighbour);
+            }
+            cellSizes[v] = static_cast<Index>(polygon.size());
         }
-    }
+    });
 
-    VRM_ASSERT_MSG(justInCase > 0, "Too many flips were made when adding a vertex to the triangulation while keeping Delaunay property.");
+    /* Merging, the threads having worked on consecutive vertices */
 
-    return flipsCount;
+    diagram.cellOffsets.resize(m_Vertices.size() + 1, 0);
+    for (size_t v = 0; v < m_Vertices.size(); v++)
+        diagram.cellOffsets[v + 1] = diagram.cellOffsets[v] + cellSizes[v];
+
+    diagram.cellVertices.reserve(diagram.cellOffsets.back());
+    diagram.cellNeighbours.reserve(diagram.cellOffsets.back());
+    for (const auto& cells : threadCells)
+    {
+        diagram.cellNeighbours.insert(diagram.cellNeighbours.end(), cells.cellNeighbours.begin(), cells.cellNeighbours.end());
+
+        const Index offset = static_cast<Index>(diagram.vertices.size() - diagram.circumcenterCount);
+        for (const Index index : cells.cellVertices)
+            diagram.cellVertices.push_back(index < diagram.circumcenterCount ? index : index + offset);
+
+        diagram.vertices.insert(diagram.vertices.end(), cells.clippingPoints.begin(), cells.clippingPoints.end());
+    }
+
+    return diagram;
 }
 
-template<>
-struct std::hash<TriangularMesh::Edge>
+int TriangularMesh::delaunayAlgorithm(std::vector<Corner>& edgeStack)
 {
-    std::size_t operator()(const TriangularMesh::Edge& e) const noexcept
+    size_t justInCase = 1'000;
+    int flipsCount = 0;
+
+    for ( ; !edgeStack.empty() && justInCase != 0; --justInCase)
     {
-        auto hasher = std::hash<size_t>();
-        auto seed = hasher(e.e0);
-        hash_combine(seed, e.e1);
-        return seed;
+        const auto [face, local] = edgeStack.back();
+        edgeStack.pop_back();
+
+        // Edges of the convex hull and constrained edges are never flipped
+        if (isFaceInfinite(face) || isFaceInfinite(m_Faces.at(face).neighbours[local]) || m_Faces.at(face).isConstrained(local))
+            continue;
+
+        if (isEdgeDelaunay(face, local))
+            continue;
+
+        // The faces are now (A, B, D) and (D, C, A): their outer edges may not be Delaunay anymore
+        Edge e = edgeFlip(face, local);
+        // The edge DA of t0 faces the edge AD of t1, which is opposite to C
+        glm::length_t d = (oppositeLocalIndex(e.t0, (local + 1) % 3) + 2) % 3;
+
+        edgeStack.push_back(Corner{ e.t0, local });
+        edgeStack.push_back(Corner{ e.t0, (local + 2) % 3 });
+        edgeStack.push_back(Corner{ e.t1, d });
+        edgeStack.push_back(Corner{ e.t1, (d + 2) % 3 });
+
+        ++flipsCount;
     }
-};
 
-bool operator==(const TriangularMesh::Edge& left, const TriangularMesh::Edge& right)
-{
-    return left.e0 == right.e0 && left.e1 == right.e1;
+    VRM_ASSERT_MSG(justInCase > 0, "Too many flips were made when adding a vertex to the triangulation while keeping Delaunay property.");
+
+    return flipsCount;
 }
 
 int TriangularMesh::delaunayAlgorithm()
 {
-    std::unordered_set<Edge> edges;
+    std::vector<Corner> edgeStack;
 
     for (size_t i = 0; i < m_Faces.size(); i++)
     {
@@ -630,34 +2493,13 @@ int TriangularMesh::delaunayAlgorithm()
         
         const auto& f = m_Faces.at(i);
 
+        // Each edge is pushed once, from its face with the smallest index
         for (glm::length_t j = 0; j < 3; j++)
-        {
-            auto i_neighbour = f.neighbours[j];
-
-            if (isFaceInfinite(i_neighbour))
-                continue;
-
-            const auto& f_neighbour = m_Faces.at(i_neighbour);
-
-            Edge e;
-            e.e0 = f.indices[(j + 1) % 3];
-            e.e1 = f.indices[(j + 2) % 3];
-
-            if (edges.contains(e))
-                continue;
-
-            std::swap(e.e0, e.e1);
-
-            e.t0 = i;
-            e.t1 = i_neighbour;
-
-            edges.insert(e);
-        }
+            if (i < f.neighbours[j] && !isFaceInfinite(f.neighbours[j]))
+                edgeStack.push_back(Corner{ static_cast<Index>(i), j });
     }
 
-    std::deque<Edge> checkList(edges.begin(), edges.end());
-
-    return delaunayAlgorithm(checkList);
+    return delaunayAlgorithm(edgeStack);
 }
 
 size_t TriangularMesh::getVertexCount() const
@@ -683,17 +2525,17 @@ glm::length_t TriangularMesh::localVertexIndex(size_t globalVertexIndex, size_t
     return -1;
 }
 
-size_t TriangularMesh::globalVertexIndex(glm::length_t localVertexIndex, size_t faceIndex) const
+TriangularMesh::Index TriangularMesh::globalVertexIndex(glm::length_t localVertexIndex, size_t faceIndex) const
 {
     return m_Faces.at(faceIndex).indices[localVertexIndex];
 }
 
-size_t TriangularMesh::firstFaceIndex(size_t vertexIndex) const
+TriangularMesh::Index TriangularMesh::firstFaceIndex(size_t vertexIndex) const
 {
     return m_Vertices.at(vertexIndex).faceIndex;
 }
 
-size_t TriangularMesh::CCWFaceIndex(size_t vertexIndex, size_t faceIndex) const
+TriangularMesh::Index TriangularMesh::CCWFaceIndex(size_t vertexIndex, size_t faceIndex) const
 {
     const auto& f = m_Faces.at(faceIndex);
     size_t v_local = localVertexIndex(vertexIndex, faceIndex);
@@ -701,7 +2543,7 @@ size_t TriangularMesh::CCWFaceIndex(size_t vertexIndex, size_t faceIndex) const
     return f.neighbours[(v_local + 1) % 3];
 }
 
-size_t TriangularMesh::CWFaceIndex(size_t vertexIndex, size_t faceIndex) const
+TriangularMesh::Index TriangularMesh::CWFaceIndex(size_t vertexIndex, size_t faceIndex) const
 {
     const auto& f = m_Faces.at(faceIndex);
     size_t v_local = localVertexIndex(vertexIndex, faceIndex);
@@ -709,7 +2551,7 @@ size_t TriangularMesh::CWFaceIndex(size_t vertexIndex, size_t faceIndex) const
     return f.neighbours[(v_local + 2) % 3];
 }
 
-size_t TriangularMesh::oppositeFaceIndex(size_t vertexIndex, size_t faceIndex) const
+TriangularMesh::Index TriangularMesh::oppositeFaceIndex(size_t vertexIndex, size_t faceIndex) const
 {
     const auto& f = m_Faces.at(faceIndex);
     glm::length_t v_local = localVertexIndex(vertexIndex, faceIndex);
@@ -717,6 +2559,52 @@ size_t TriangularMesh::oppositeFaceIndex(size_t vertexIndex, size_t faceIndex) c
     return f.neighbours[v_local];
 }
 
+TriangularMesh::Index TriangularMesh::newVertex(const Vertex& v)
+{
+    if (m_FreeVertices.empty())
+        return addVertex(v);
+
+    const Index vertexIndex = m_FreeVertices.back();
+    m_FreeVertices.pop_back();
+
+    m_Vertices.at(vertexIndex) = v;
+    return vertexIndex;
+}
+
+TriangularMesh::Index TriangularMesh::newFace()
+{
+    if (m_FreeFaces.empty())
+    {
+        VRM_ASSERT_MSG(m_Faces.size() < std::numeric_limits<Index>::max(), "Too many faces for the index type.");
+
+        m_Faces.emplace_back();
+        return m_Faces.size() - 1;
+    }
+
+    const Index faceIndex = m_FreeFaces.back();
+    m_FreeFaces.pop_back();
+
+    m_Faces.at(faceIndex) = Face();
+    return faceIndex;
+}
+
+glm::length_t TriangularMesh::oppositeLocalIndex(size_t faceIndex, glm::length_t localEdgeIndex) const
+{
+    return m_Faces.at(faceIndex).oppositeLocal(localEdgeIndex);
+}
+
+void TriangularMesh::linkFaces(size_t faceIndex0, glm::length_t localEdgeIndex0, size_t faceIndex1, glm::length_t localEdgeIndex1)
+{
+    auto& f0 = m_Faces.at(faceIndex0);
+    auto& f1 = m_Faces.at(faceIndex1);
+
+    f0.neighbours[localEdgeIndex0] = faceIndex1;
+    f0.setOppositeLocal(localEdgeIndex0, localEdgeIndex1);
+
+    f1.neighbours[localEdgeIndex1] = faceIndex0;
+    f1.setOppositeLocal(localEdgeIndex1, localEdgeIndex0);
+}
+
 void TriangularMesh::printVertexPosition(size_t vertexIndex) const
 {
     const auto& v = m_Vertices.at(vertexIndex);
@@ -781,6 +2669,9 @@ void TriangularMesh::integrityTest() const
     // Test in faces    
     for (size_t i = 0; i < m_Faces.size(); i++)
     {
+        if (m_IsForTriangulation && isFaceFree(i))
+            continue;
+
         const auto& f = m_Faces.at(i);
         
         // Check if all vertices exist
@@ -799,11 +2690,27 @@ void TriangularMesh::integrityTest() const
         VRM_ASSERT(nf1.n0 == i || nf1.n1 == i || nf1.n2 == i);
         auto& nf2 = m_Faces.at(f.n2);
         VRM_ASSERT(nf2.n0 == i || nf2.n1 == i || nf2.n2 == i);
+
+        // Check if the opposite local indices point back to f, across the same edge
+        for (glm::length_t j = 0; j < 3; j++)
+        {
+            const auto& nf = m_Faces.at(f.neighbours[j]);
+            const glm::length_t o = f.oppositeLocal(j);
+
+            VRM_ASSERT(nf.neighbours[o] == i);
+            VRM_ASSERT(nf.oppositeLocal(o) == j);
+            VRM_ASSERT(nf.isConstrained(o) == f.isConstrained(j));
+            VRM_ASSERT(nf.indices[(o + 1) % 3] == f.indices[(j + 2) % 3]);
+            VRM_ASSERT(nf.indices[(o + 2) % 3] == f.indices[(j + 1) % 3]);
+        }
     }
 
     // Vertices: test if each vertex starts on a face containing the vertex
     for (size_t i = 0; i < m_Vertices.size(); i++)
     {
+        if (isVertexFree(i))
+            continue;
+
         auto& v = m_Vertices.at(i);
         auto& f = m_Faces.at(v.faceIndex);
 
@@ -819,47 +2726,51 @@ void TriangularMesh::loadOFF(const std::string& path)
     m_Vertices.clear();
     m_Faces.clear();
     m_MetEdges.clear();
+    m_FreeVertices.clear();
+    m_FreeFaces.clear();
+    m_HierarchyLevels.clear();
 
-    std::ifstream ifs;
-
-    ifs.open(path);
-    VRM_ASSERT(ifs.is_open());
+    const MappedFile file(path);
+    VRM_ASSERT(file.isOpen());
 
-    std::string line;
-    std::getline(ifs, line); // OFF
+    std::string_view text = file.getContent();
+    TextParser::NextLine(text); // OFF
 
     size_t verticesNb = 0;
     size_t facesNb = 0;
 
-    std::getline(ifs, line);
-    std::stringstream ss(line);
-    
-    ss >> verticesNb;
-    ss >> facesNb;
+    std::string_view header = TextParser::NextLine(text);
+    TextParser::ParseNumber(header, verticesNb);
+    TextParser::ParseNumber(header, facesNb);
 
-    while(m_Vertices.size() < verticesNb && std::getline(ifs, line))
-    {
-        ss = std::stringstream(line);
-        Vertex v;
-        ss >> v.position.x;
-        ss >> v.position.y;
-        ss >> v.position.z;
-        addVertex(v);
-    }
+    m_Vertices.resize(verticesNb, Vertex{ glm::vec3(0.f), InvalidIndex });
+    m_Faces.resize(facesNb);
 
-    while(m_Faces.size() < facesNb && std::getline(ifs, line))
+    // Vertex lines, then face lines. Errors are reported once the parsing threads are joined
+    std::atomic<bool> isValid = true;
+    const size_t linesNb = TextParser::ParseLines(text, [this, verticesNb, facesNb, &isValid](std::string_view line, size_t lineIndex)
     {
-        ss = std::stringstream(line);
-        size_t i0, i1, i2;
-        size_t faces;
-        ss >> faces;
-        VRM_ASSERT(faces == 3);
+        if (lineIndex < verticesNb)
+        {
+            glm::vec3& position = m_Vertices[lineIndex].position;
+            if (!TextParser::ParseNumber(line, position.x) || !TextParser::ParseNumber(line, position.y) || !TextParser::ParseNumber(line, position.z))
+                isValid = false;
+        }
+        else if (lineIndex < verticesNb + facesNb)
+        {
+            size_t faces = 0;
+            size_t i0 = 0, i1 = 0, i2 = 0;
+            if (!TextParser::ParseNumber(line, faces) || faces != 3
+                || !TextParser::ParseNumber(line, i0) || !TextParser::ParseNumber(line, i1) || !TextParser::ParseNumber(line, i2)
+                || i0 >= verticesNb || i1 >= verticesNb || i2 >= verticesNb)
+                isValid = false;
+            else
+                m_Faces[lineIndex - verticesNb].indices = glm::vec<3, Index>(i0, i1, i2);
+        }
+    });
+    VRM_ASSERT_MSG(isValid && linesNb >= verticesNb + facesNb, "File {} is not a valid triangular .off file.", path);
 
-        ss >> i0;
-        ss >> i1;
-        ss >> i2;
-        addFace(i0, i1, i2);
-    }
+    buildAdjacency();
 
     VRM_LOG_INFO("{} vertices and {} faces loaded.", m_Vertices.size(), m_Faces.size());
 }
@@ -891,6 +2802,136 @@ void TriangularMesh::saveOFF(const std::string& path) const
     VRM_LOG_INFO("File {} written.", path);
 }
 
+namespace
+{
+    // To be increased whenever the layout of the vertices or faces changes
+    constexpr uint32_t BinaryVersion = 2;
+    constexpr std::array<char, 4> BinaryMagic = { 'T', 'P', 'M', 'B' };
+
+    struct BinaryHeader
+    {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t indexSize, vertexSize, faceSize;
+        uint32_t isForTriangulation;
+        uint64_t sourceChecksum;
+        uint64_t vertexCount, faceCount, freeVertexCount, freeFaceCount;
+        uint64_t infiniteVertexIndex;
+        uint64_t payloadChecksum;
+    };
+}
+
+bool TriangularMesh::saveBinary(const std::filesystem::path& path, uint64_t sourceChecksum) const
+{
+    auto bytes = [](const auto& vector) { return std::string_view(reinterpret_cast<const char*>(vector.data()), vector.size() * sizeof(vector[0])); };
+
+    uint64_t payloadChecksum = Checksum(bytes(m_Vertices));
+    payloadChecksum = Checksum(bytes(m_Faces), payloadChecksum);
+    payloadChecksum = Checksum(bytes(m_FreeVertices), payloadChecksum);
+    payloadChecksum = Checksum(bytes(m_FreeFaces), payloadChecksum);
+
+    const BinaryHeader header = {
+        .magic = BinaryMagic,
+        .version = BinaryVersion,
+        .indexSize = sizeof(Index),
+        .vertexSize = sizeof(Vertex),
+        .faceSize = sizeof(Face),
+        .isForTriangulation = m_IsForTriangulation,
+        .sourceChecksum = sourceChecksum,
+        .vertexCount = m_Vertices.size(),
+        .faceCount = m_Faces.size(),
+        .freeVertexCount = m_FreeVertices.size(),
+        .freeFaceCount = m_FreeFaces.size(),
+        .infiniteVertexIndex = m_InfiniteVertexIndex,
+        .payloadChecksum = payloadChecksum
+    };
+
+    // Written next to the cache and renamed over it, so that an interrupted write never leaves a truncated cache
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+    bool isWritten = false;
+    {
+        std::ofstream ofs(tempPath, std::ios_base::binary | std::ios_base::trunc);
+        if (!ofs.is_open())
+            return false;
+
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const std::string_view payload : { bytes(m_Vertices), bytes(m_Faces), bytes(m_FreeVertices), bytes(m_FreeFaces) })
+            ofs.write(payload.data(), payload.size());
+
+        ofs.close();
+        isWritten = ofs.good();
+    }
+
+    std::error_code error;
+    if (isWritten)
+    {
+        std::filesystem::rename(tempPath, path, error);
+        if (!error)
+            return true;
+    }
+
+    std::filesystem::remove(tempPath, error);
+    return false;
+}
+
+bool TriangularMesh::loadBinary(const std::filesystem::path& path, uint64_t sourceChecksum)
+{
+    const MappedFile file(path);
+    if (!file.isOpen())
+        return false;
+
+    const std::string_view content = file.getContent();
+    if (content.size() < sizeof(BinaryHeader))
+        return false;
+
+    BinaryHeader header;
+    std::memcpy(&header, content.data(), sizeof(header));
+
+    if (header.magic != BinaryMagic || header.version != BinaryVersion || header.indexSize != sizeof(Index)
+        || header.vertexSize != sizeof(Vertex) || header.faceSize != sizeof(Face) || header.sourceChecksum != sourceChecksum)
+        return false;
+
+    const size_t size = sizeof(header) + header.vertexCount * sizeof(Vertex) + header.faceCount * sizeof(Face)
+        + (header.freeVertexCount + header.freeFaceCount) * sizeof(Index);
+    if (content.size() != size || Checksum(content.substr(sizeof(header))) != header.payloadChecksum)
+        return false;
+
+    clear();
+
+    const char* data = content.data() + sizeof(header);
+    auto read = [&data](auto& vector, size_t count)
+    {
+        vector.resize(count);
+        std::memcpy(vector.data(), data, count * sizeof(vector[0]));
+        data += count * sizeof(vector[0]);
+    };
+    read(m_Vertices, header.vertexCount);
+    read(m_Faces, header.faceCount);
+    read(m_FreeVertices, header.freeVertexCount);
+    read(m_FreeFaces, header.freeFaceCount);
+
+    m_IsForTriangulation = header.isForTriangulation;
+    m_InfiniteVertexIndex = static_cast<Index>(header.infiniteVertexIndex);
+
+    buildHierarchy();
+
+    return true;
+}
+
+uint64_t TriangularMesh::Checksum(std::string_view data, uint64_t seed)
+{
+    uint64_t hash = seed;
+    for (const char c : data)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
 vrm::MeshData TriangularMesh::toMeshData() const
 {
     std::vector<vrm::Vertex> vertices;
@@ -939,8 +2980,71 @@ vrm::MeshData TriangularMesh::toMeshData() const
     return vrm::MeshData{ std::move(vertices), std::move(indices) };
 }
 
+vrm::MeshData TriangularMesh::VoronoiDiagram::toMeshData(float height, float lineWidth) const
+{
+    std::vector<vrm::Vertex> meshVertices;
+    std::vector<uint32_t> indices;
+
+    auto addVertex = [&meshVertices](const glm::vec2& p, float height)
+    {
+        vrm::Vertex v;
+        v.position = { p.x, height, p.y };
+        v.normal = { 0.f, 1.f, 0.f };
+        v.texCoords = { 0.f, 0.f };
+        v.scalar = 0.f;
+        meshVertices.push_back(v);
+    };
+
+    for (size_t v = 0; v + 1 < cellOffsets.size(); v++)
+    {
+        for (Index k = cellOffsets[v]; k < cellOffsets[v + 1]; k++)
+        {
+            const Index a = cellVertices[k];
+            const Index b = cellVertices[k + 1 < cellOffsets[v + 1] ? k + 1 : cellOffsets[v]];
+
+            // Edges shared with the cell of a smaller vertex are drawn with that cell
+            const Index neighbour = cellNeighbours[k];
+            if (neighbour < v && cellOffsets[neighbour] != cellOffsets[neighbour + 1])
+                continue;
+
+            const glm::vec2 direction = vertices[b] - vertices[a];
+            const float length = glm::length(direction);
+            if (length == 0.f)
+                continue;
+
+            // Facing up, like the faces of the triangulation
+            const glm::vec2 normal = glm::vec2(-direction.y, direction.x) * (lineWidth / (2.f * length));
+
+            const uint32_t indexOffset = static_cast<uint32_t>(meshVertices.size());
+            addVertex(vertices[a] + normal, height);
+            addVertex(vertices[b] + normal, height);
+            addVertex(vertices[b] - normal, height);
+            addVertex(vertices[a] - normal, height);
+
+            for (const uint32_t index : { 0u, 1u, 2u, 0u, 2u, 3u })
+                indices.push_back(indexOffset + index);
+        }
+    }
+
+    return vrm::MeshData{ std::move(meshVertices), std::move(indices) };
+}
+
 vrm::MeshData TriangularMesh::toSmoothMeshData() const
 {
+    return toSmoothMeshData(CotanLaplacian(*this));
+}
+
+vrm::MeshData TriangularMesh::toSmoothMeshData(const CotanLaplacian& laplacian) const
+{
+    VRM_ASSERT_MSG(laplacian.getVertexCount() == m_Vertices.size(), "The Laplacian was assembled on another mesh.");
+
+    std::vector<glm::vec3> positions(m_Vertices.size());
+    for (size_t i = 0; i < m_Vertices.size(); i++)
+        positions[i] = m_Vertices[i].position;
+
+    std::vector<glm::vec3> normals(m_Vertices.size());
+    laplacian.apply(positions, normals);
+
     std::vector<vrm::Vertex> vertices;
     std::vector<uint32_t> indices;
 
@@ -949,7 +3053,7 @@ vrm::MeshData TriangularMesh::toSmoothMeshData() const
 
     for (size_t i = 0; i < m_Vertices.size(); i++)
     {
-        if (isFaceInfinite(m_Vertices.at(i).faceIndex))
+        if (isVertexFree(i) || isFaceInfinite(m_Vertices.at(i).faceIndex))
             continue;
 
         Face f = m_Faces.at(m_Vertices.at(i).faceIndex);
@@ -957,8 +3061,7 @@ vrm::MeshData TriangularMesh::toSmoothMeshData() const
         v.position = m_Vertices.at(i).position;
         v.texCoords = { 0.f, 0.f };
 
-        auto positionFunction = [this](size_t i) -> glm::vec3 { return m_Vertices.at(i).position; };
-        v.normal = laplacian(i, positionFunction);
+        v.normal = normals[i];
 
         const glm::vec3 AB = m_Vertices.at(f.i1).position - m_Vertices.at(f.i0).position;
         const glm::vec3 AC = m_Vertices.at(f.i2).position - m_Vertices.at(f.i0).position;
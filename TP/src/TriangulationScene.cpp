@@ -13,11 +13,15 @@
 
 #include <glm/gtx/string_cast.hpp>
 
+#include <atomic>
+
 #include "imgui.h"
 
 #include "RayCasting.h"
 
 #include "ScopeProfiler.h"
+#include "Predicates.h"
+#include "TextParser.h"
 
 TriangulationScene::TriangulationScene()
     : vrm::Scene(), m_Camera(0.1f, 100'000.f, glm::radians(90.f), 600.f / 400.f, { 0.f, 20.f, 0.f }, { glm::radians(90.f), 0.f, 0.f })
@@ -132,14 +136,41 @@ void TriangulationScene::onImGui()
         if (ImGui::Checkbox("Wireframe", &m_WireFrame))
             getEntity("TriangularMesh").getComponent<vrm::MeshComponent>().setWireframe(m_WireFrame);
 
+        // The Voronoi diagram needs the hull of the triangulation, which the naive mode does not keep
+        if (m_TriangulationMode != TriangulationMode::NAIVE && ImGui::Checkbox("Show Voronoi diagram", &m_ShowVoronoiDiagram))
+            updateVoronoiDiagram();
+
         ImGui::Checkbox("Check mesh integrity when updating", &m_IntegrityTestWhenUpdating);
 
+        if (ImGui::Checkbox("Delaunay hierarchy for point location", &m_UseHierarchy))
+            m_TriangularMesh.setHierarchyEnabled(m_UseHierarchy);
+
+        if (ImGui::BeginCombo("Insertion kernel", m_InsertionKernelLabel.c_str()))
+        {
+            if (ImGui::Selectable("Flips"))
+            {
+                m_InsertionKernelLabel = "Flips";
+                m_InsertionKernel = TriangularMesh::InsertionKernel::FLIPS;
+            }
+            if (ImGui::Selectable("Bowyer-Watson"))
+            {
+                m_InsertionKernelLabel = "Bowyer-Watson";
+                m_InsertionKernel = TriangularMesh::InsertionKernel::BOWYER_WATSON;
+            }
+            ImGui::EndCombo();
+        }
+
         if (ImGui::BeginCombo("Triangulation mode", m_TriangulationModeLabel.c_str()))
         {
             if (ImGui::Selectable("Naive") && m_TriangulationMode != TriangulationMode::NAIVE)
             {
                 m_TriangulationModeLabel = "Naive";
                 m_TriangulationMode = TriangulationMode::NAIVE;
+                if (m_EditMode == EditMode::REMOVE_VERTEX)
+                {
+                    m_EditModeLabel = "Place vertices";
+                    m_EditMode = EditMode::PLACE_VERTICES;
+                }
                 resetTriangularMesh();
 
                 m_Camera.setNear(0.1f);
@@ -153,6 +184,11 @@ void TriangulationScene::onImGui()
             {
                 m_TriangulationModeLabel = "Continuous Delaunay";
                 m_TriangulationMode = TriangulationMode::CONTINUOUS_DELAUNAY;
+                if (m_EditMode == EditMode::FLIP_EDGE)
+                {
+                    m_EditModeLabel = "Place vertices";
+                    m_EditMode = EditMode::PLACE_VERTICES;
+                }
                 resetTriangularMesh();
 
                 m_Camera.setNear(0.1f);
@@ -179,7 +215,7 @@ void TriangulationScene::onImGui()
             ImGui::EndCombo();
         }
 
-        if (m_TriangulationMode == TriangulationMode::NAIVE)
+        if (m_TriangulationMode == TriangulationMode::NAIVE || m_TriangulationMode == TriangulationMode::CONTINUOUS_DELAUNAY)
         {
             if (ImGui::BeginCombo("Edit mode", m_EditModeLabel.c_str()))
             {
@@ -188,11 +224,18 @@ void TriangulationScene::onImGui()
                     m_EditModeLabel = "Place vertices";
                     m_EditMode = EditMode::PLACE_VERTICES;
                 }
-                if (ImGui::Selectable("Flip edge") && m_EditMode != EditMode::FLIP_EDGE)
+                // Flipping an edge would break the Delaunay property
+                if (m_TriangulationMode == TriangulationMode::NAIVE && ImGui::Selectable("Flip edge") && m_EditMode != EditMode::FLIP_EDGE)
                 {
                     m_EditModeLabel = "Flip edge";
                     m_EditMode = EditMode::FLIP_EDGE;
                 }
+                // Holes are filled with Delaunay triangles, which only fit in a Delaunay triangulation
+                if (m_TriangulationMode == TriangulationMode::CONTINUOUS_DELAUNAY && ImGui::Selectable("Remove vertex") && m_EditMode != EditMode::REMOVE_VERTEX)
+                {
+                    m_EditModeLabel = "Remove vertex";
+                    m_EditMode = EditMode::REMOVE_VERTEX;
+                }
 
                 ImGui::EndCombo();
             }
@@ -216,7 +259,7 @@ void TriangulationScene::onImGui()
             {
                 for (const auto& file : std::filesystem::directory_iterator(std::filesystem::current_path() / "Resources" / "TerrainData"))
                 {
-                    if (file.is_directory())
+                    if (file.is_directory() || file.path().extension() == ".breaklines")
                         continue;
 
                     std::string fileName = file.path().filename().string();
@@ -239,8 +282,42 @@ void TriangulationScene::onImGui()
 
                 if (ImGui::Button("Delaunay triangulation"))
                 {
-                    delaunayTriangulation(m_TerrainDataPath);
+                    // The insertion kernels may choose other diagonals between cocircular points
+                    triangulateWithCache(m_TerrainDataPath, "delaunay", m_InsertionKernelLabel, [this]() { delaunayTriangulation(m_TerrainDataPath); });
+                }
+
+                if (ImGui::Button("Batch Delaunay triangulation"))
+                {
+                    // So may the strips of another threads count
+                    triangulateWithCache(m_TerrainDataPath, "batch", std::to_string(m_ThreadCount), [this]() { batchDelaunayTriangulation(m_TerrainDataPath); });
+                }
+
+                ImGui::SliderInt("Batch triangulation threads", &m_ThreadCount, 1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+
+                ImGui::Checkbox("Insert breaklines", &m_InsertBreaklines);
+
+                ImGui::Checkbox("Use triangulation cache", &m_UseTriangulationCache);
+            }
+
+            if (ImGui::Button("Benchmark all terrain data"))
+                benchmarkTerrainData();
+        }
+
+        // Steiner points are inserted while keeping the Delaunay property, which the naive triangulation does not have
+        if (m_TriangulationMode != TriangulationMode::NAIVE)
+        {
+            ImGui::SliderFloat("Refinement min angle", &m_RefinementMinAngle, 0.f, 20.7f, "%.1f deg");
+            ImGui::InputFloat("Refinement max area (0 for none)", &m_RefinementMaxArea);
+
+            if (ImGui::Button("Refine"))
+            {
+                int steinerPointsCount = 0;
+                {
+                    PROFILE_SCOPE_VARIABLE(m_LastProcessTime);
+                    steinerPointsCount = m_TriangularMesh.refine(m_RefinementMinAngle, m_RefinementMaxArea > 0.f ? m_RefinementMaxArea : std::numeric_limits<float>::infinity());
                 }
+                VRM_LOG_INFO("Refinement inserted {} Steiner points.", steinerPointsCount);
+                updateTriangularMesh();
             }
         }
 
@@ -292,12 +369,20 @@ void TriangulationScene::onRightClick(int mouseX, int mouseY)
             updateTriangularMesh();
         }
     }
+    else if (m_TriangulationMode == TriangulationMode::CONTINUOUS_DELAUNAY && m_EditMode == EditMode::REMOVE_VERTEX)
+    {
+        {
+            PROFILE_SCOPE_VARIABLE(m_LastProcessTime);
+            m_TriangularMesh.removeVertex(glm::vec3(hit.position.x, 0.f, hit.position.z));
+        }
+        updateTriangularMesh();
+    }
     else if (m_TriangulationMode == TriangulationMode::CONTINUOUS_DELAUNAY)
     {
         VRM_LOG_INFO("Placing vertex at {}", glm::to_string(hit.position));
         {
             PROFILE_SCOPE_VARIABLE(m_LastProcessTime);
-            m_LastFlipsCount = m_TriangularMesh.addVertex_StreamingDelaunayTriangulation(hit.position);
+            m_LastFlipsCount = m_TriangularMesh.addVertex_StreamingDelaunayTriangulation(hit.position, m_InsertionKernel);
         }
         updateTriangularMesh();
     }
@@ -306,125 +391,319 @@ void TriangulationScene::onRightClick(int mouseX, int mouseY)
 
 void TriangulationScene::naiveTriangulation(const std::filesystem::path& data)
 {
-    std::ifstream ifs(data);
-    VRM_ASSERT_MSG(ifs.is_open(), "Couldn't open file {}.", data.string());
+    std::vector<float> heights;
+    {
+        PROFILE_SCOPE_VARIABLE(m_LastProcessTime);
+
+        const auto points = readTerrainPoints(data, &heights);
+        setupTriangulation(points);
+
+        for (size_t i = 3; i < points.size(); i++)
+            m_TriangularMesh.addVertex_StreamingTriangulation(points[i]);
+    }
+
+    fixHeights(heights);
+
+    updateTriangularMesh();
+}
 
+void TriangulationScene::delaunayTriangulation(const std::filesystem::path& data)
+{
+    std::vector<float> heights;
     {
         PROFILE_SCOPE_VARIABLE(m_LastProcessTime);
-        auto vertexCount = setupTriangulation(ifs);
 
-        std::string line;
-        while (std::getline(ifs, line))
-        {
-            std::stringstream sstream(line);
-            glm::vec3 v;
-            std::string token;
+        const auto points = readTerrainPoints(data, &heights);
+        setupTriangulation(points);
+
+        m_LastFlipsCount = m_TriangularMesh.insertPoints(std::span(points).subspan(3), m_InsertionKernel);
+    }
 
-            sstream >> token;
-            v.x = std::stof(token);
-            sstream >> token;
-            v.z = std::stof(token);
-            v.y = 0.f;
+    if (m_InsertBreaklines)
+        insertBreaklines(data, true);
 
-            m_TriangularMesh.addVertex_StreamingTriangulation(v);
-        }
+    fixHeights(heights);
+
+    updateTriangularMesh();
+}
+
+void TriangulationScene::batchDelaunayTriangulation(const std::filesystem::path& data)
+{
+    {
+        PROFILE_SCOPE_VARIABLE(m_LastProcessTime);
+        auto points = readTerrainPoints(data);
+        m_TriangularMesh.buildDelaunayParallel(points, static_cast<size_t>(m_ThreadCount));
     }
 
-    fixHeights(ifs);
+    if (m_InsertBreaklines)
+        insertBreaklines(data, false);
+
+    m_LastFlipsCount = -1;
 
     updateTriangularMesh();
 }
 
-void TriangulationScene::delaunayTriangulation(const std::filesystem::path& data)
+void TriangulationScene::triangulateWithCache(const std::filesystem::path& data, const std::string& kind, const std::string& settings, const std::function<void()>& triangulate)
 {
-    std::ifstream ifs(data);
-    VRM_ASSERT_MSG(ifs.is_open(), "Couldn't open file {}.", data.string());
+    if (!m_UseTriangulationCache)
+    {
+        triangulate();
+        return;
+    }
+
+    // One cache per triangulation kind, in a directory which the terrain data lists skip
+    const auto cachePath = data.parent_path() / "Cache" / (data.stem().string() + "." + kind + ".tpmesh");
 
+    // The breaklines setting and the triangulation settings change the triangulation, so they are part of the source
+    bool isLoaded = false;
+    uint64_t checksum = 0;
     {
         PROFILE_SCOPE_VARIABLE(m_LastProcessTime);
-        auto vertexCount = setupTriangulation(ifs);
 
-        std::string line;
-        while (std::getline(ifs, line))
-        {
-            std::stringstream sstream(line);
-            glm::vec3 v;
-            std::string token;
+        checksum = TriangularMesh::Checksum(MappedFile(data).getContent());
+        const auto breaklinesPath = std::filesystem::path(data).replace_extension(".breaklines");
+        if (m_InsertBreaklines && std::filesystem::exists(breaklinesPath))
+            checksum = TriangularMesh::Checksum(MappedFile(breaklinesPath).getContent(), checksum);
+        checksum = TriangularMesh::Checksum(settings, checksum);
 
-            sstream >> token;
-            v.x = std::stof(token);
-            sstream >> token;
-            v.z = std::stof(token);
-            v.y = 0.f;
+        isLoaded = m_TriangularMesh.loadBinary(cachePath, checksum);
+    }
 
-            m_TriangularMesh.addVertex_StreamingDelaunayTriangulation(v);
-        }
+    if (isLoaded)
+    {
+        VRM_LOG_INFO("{} loaded from cache in {:.6f} s.", cachePath.filename().string(), m_LastProcessTime);
+        m_LastFlipsCount = -1;
+        updateTriangularMesh();
+        return;
     }
 
-    fixHeights(ifs);
+    triangulate();
 
-    updateTriangularMesh();
+    std::error_code error;
+    std::filesystem::create_directories(cachePath.parent_path(), error);
+    if (error || !m_TriangularMesh.saveBinary(cachePath, checksum))
+        VRM_LOG_WARN("Couldn't write triangulation cache {}.", cachePath.string());
 }
 
-unsigned long long TriangulationScene::setupTriangulation(std::ifstream& ifs)
+std::vector<glm::vec3> TriangulationScene::readTerrainPoints(const std::filesystem::path& data, std::vector<float>* heights)
 {
-    m_TriangularMesh.clear();
+    const MappedFile file(data);
+    VRM_ASSERT_MSG(file.isOpen(), "Couldn't open file {}.", data.string());
 
-    std::string line;
+    std::string_view text = file.getContent();
+    std::string_view header = TextParser::NextLine(text);
 
-    std::getline(ifs, line);
-    auto vertexCount = std::stoull(line);
+    size_t pointCount = 0;
+    TextParser::ParseNumber(header, pointCount);
 
-    std::array<size_t, 3> vertexIndices;
-    std::array<glm::vec2, 3> vertices;
-    TriangularMesh::Vertex v;
+    std::vector<glm::vec3> points(pointCount);
+    if (heights)
+        heights->resize(pointCount);
 
-    for (uint8_t i = 0; i < 3; ++i)
+    // Errors are reported once the parsing threads are joined
+    std::atomic<bool> isValid = true;
+    const size_t lineCount = TextParser::ParseLines(text, [&points, heights, &isValid](std::string_view line, size_t lineIndex)
     {
-        std::getline(ifs, line);
-        std::stringstream sstream(line);
+        if (lineIndex >= points.size())
+            return;
+
+        glm::vec3& p = points[lineIndex];
+        float height = 0.f;
+        if (!TextParser::ParseNumber(line, p.x) || !TextParser::ParseNumber(line, p.z) || !TextParser::ParseNumber(line, height))
+        {
+            isValid = false;
+            return;
+        }
 
-        std::string token;
+        p.y = heights ? 0.f : height;
+        if (heights)
+            (*heights)[lineIndex] = height;
+    });
+    VRM_ASSERT_MSG(isValid && lineCount >= pointCount, "Invalid terrain data in {}.", data.string());
 
-        sstream >> token;
-        v.position.x = std::stof(token);
-        sstream >> token;
-        v.position.z = std::stof(token);
-        v.position.y = 0.f;
+    return points;
+}
 
-        vertices[i] = glm::vec2(v.position.x, -v.position.z);
-        vertexIndices[i] = m_TriangularMesh.addVertex(v);
+size_t TriangulationScene::insertBreaklines(const std::filesystem::path& data, bool infiniteVertexAfterFirstFace)
+{
+    const auto path = std::filesystem::path(data).replace_extension(".breaklines");
+    if (!std::filesystem::exists(path))
+        return 0;
+
+    // Streaming triangulations add the infinite vertex right after the first face
+    auto vertexIndex = [infiniteVertexAfterFirstFace](size_t pointIndex) {
+        return (infiniteVertexAfterFirstFace && pointIndex > 2) ? pointIndex + 1 : pointIndex;
+    };
+
+    size_t segmentCount = 0;
+    size_t insertedCount = 0;
+    float duration = 0.f;
+    {
+        ScopeProfiler profiler([&duration](float d) { duration = d; });
+        insertedCount = m_TriangularMesh.insertBreaklines(path, vertexIndex, &segmentCount);
     }
 
-    if (glm::determinant(glm::mat2(vertices[1] - vertices[0], vertices[2] - vertices[0])) > 0.f)
-        m_TriangularMesh.addFirstFaceForTriangulation(vertexIndices[0], vertexIndices[1], vertexIndices[2]);
-    else
-        m_TriangularMesh.addFirstFaceForTriangulation(vertexIndices[0], vertexIndices[2], vertexIndices[1]);
+    VRM_LOG_INFO("{}: {} of {} breaklines inserted in {:.6f} s", path.filename().string(), insertedCount, segmentCount, duration);
+
+    return insertedCount;
+}
+
+void TriangulationScene::benchmarkTerrainData()
+{
+    for (const auto& file : std::filesystem::directory_iterator(std::filesystem::current_path() / "Resources" / "TerrainData"))
+    {
+        if (file.is_directory() || file.path().extension() == ".breaklines")
+            continue;
+
+        batchDelaunayTriangulation(file.path());
+        const float batchTriangulationTime = m_LastProcessTime;
+
+        // Same triangulation with both insertion kernels, the flips one is kept for the following measures
+        const auto insertionKernel = m_InsertionKernel;
+        m_InsertionKernel = TriangularMesh::InsertionKernel::BOWYER_WATSON;
+        delaunayTriangulation(file.path());
+        const float bowyerWatsonTime = m_LastProcessTime;
+
+        m_InsertionKernel = TriangularMesh::InsertionKernel::FLIPS;
+        delaunayTriangulation(file.path());
+        const float triangulationTime = m_LastProcessTime;
+        m_InsertionKernel = insertionKernel;
+
+        // Iterating on faces while skipping the infinite ones
+        float meshDataTime = 0.f;
+        {
+            ScopeProfiler profiler([&meshDataTime](float duration) { meshDataTime = duration; });
+            m_TriangularMesh.toMeshData();
+        }
+
+        VRM_LOG_INFO("Benchmark {}: {} vertices, Delaunay triangulation {:.6f} s, batch Delaunay triangulation {:.6f} s, mesh data {:.6f} s",
+            file.path().filename().string(), m_TriangularMesh.getVertexCount(), triangulationTime, batchTriangulationTime, meshDataTime);
+        VRM_LOG_INFO("Benchmark {}: flips kernel {:.6f} s ({} flips), Bowyer-Watson kernel {:.6f} s",
+            file.path().filename().string(), triangulationTime, m_LastFlipsCount, bowyerWatsonTime);
+
+        // Cost of the geometric predicates on every finite edge
+        std::vector<TriangularMesh::Edge> edges;
+        std::vector<size_t> oppositeVertices;
+        for (TriangularMesh::Index i = 0; i < m_TriangularMesh.getFaceCount(); i++)
+        {
+            if (m_TriangularMesh.isFaceInfinite(i))
+                continue;
+
+            const auto& f = m_TriangularMesh.getFace(i);
+            for (glm::length_t j = 0; j < 3; j++)
+            {
+                if (m_TriangularMesh.isFaceInfinite(f.neighbours[j]))
+                    continue;
+
+                edges.push_back({ f.indices[(j + 2) % 3], f.indices[(j + 1) % 3], i, f.neighbours[j] });
+                oppositeVertices.push_back(f.indices[j]);
+            }
+        }
+
+        float inCircleTime = 0.f, orientTime = 0.f;
+        size_t delaunayEdges = 0, visibleEdges = 0;
+        {
+            ScopeProfiler profiler([&inCircleTime](float duration) { inCircleTime = duration; });
+            for (const auto& edge : edges)
+                delaunayEdges += m_TriangularMesh.isEdgeDelaunay(edge);
+        }
+        {
+            ScopeProfiler profiler([&orientTime](float duration) { orientTime = duration; });
+            for (size_t i = 0; i < edges.size(); i++)
+                visibleEdges += m_TriangularMesh.canPointSeeEdge(m_TriangularMesh.getVertex(oppositeVertices[i]).position, edges[i].e0, edges[i].e1);
+        }
+
+        VRM_LOG_INFO("Benchmark {}: {} edges, {} Delaunay, incircle {:.2f} ns/edge, orientation {:.2f} ns/edge ({} visible)",
+            file.path().filename().string(), edges.size(), delaunayEdges,
+            inCircleTime * 1e9f / edges.size(), orientTime * 1e9f / edges.size(), visibleEdges);
+
+        // One-ring traversals, through the faces and their neighbours or through the corner table
+        size_t faceRingSum = 0, cornerRingSum = 0, ringSize = 0;
+        float faceRingTime = 0.f, cornerRingTime = 0.f;
+        {
+            ScopeProfiler profiler([&faceRingTime](float duration) { faceRingTime = duration; });
+            for (size_t v = 0; v < m_TriangularMesh.getVertexCount(); v++)
+            {
+                if (m_TriangularMesh.isVertexFree(v))
+                    continue;
+
+                const size_t firstFace = m_TriangularMesh.firstFaceIndex(v);
+                size_t face = firstFace;
+                do
+                {
+                    faceRingSum += m_TriangularMesh.globalVertexIndex((m_TriangularMesh.localVertexIndex(v, face) + 1) % 3, face);
+                    face = m_TriangularMesh.CCWFaceIndex(v, face);
+                    ringSize++;
+                } while (face != firstFace);
+            }
+        }
+        {
+            ScopeProfiler profiler([&cornerRingTime](float duration) { cornerRingTime = duration; });
+            for (size_t v = 0; v < m_TriangularMesh.getVertexCount(); v++)
+            {
+                if (m_TriangularMesh.isVertexFree(v))
+                    continue;
+
+                for (auto it = m_TriangularMesh.begin_turning_vertices(v); it != m_TriangularMesh.end_turning_vertices(v); ++it)
+                    cornerRingSum += *it;
+            }
+        }
+        VRM_ASSERT_MSG(faceRingSum == cornerRingSum, "Both one-ring traversals should meet the same vertices.");
+
+        VRM_LOG_INFO("Benchmark {}: one-ring traversal of {} neighbours, faces with neighbours {:.2f} ns/neighbour, corner table {:.2f} ns/neighbour",
+            file.path().filename().string(), ringSize, faceRingTime * 1e9f / ringSize, cornerRingTime * 1e9f / ringSize);
+
+        // Scaling of the parallel batch triangulation for each thread count, the speedup is relative to one thread
+        const auto points = readTerrainPoints(file.path());
+        const size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        float oneThreadTime = 0.f;
+
+        for (size_t threads = 1; threads <= maxThreads; threads++)
+        {
+            float parallelTime = 0.f;
+            {
+                ScopeProfiler profiler([&parallelTime](float duration) { parallelTime = duration; });
+                m_TriangularMesh.buildDelaunayParallel(points, threads);
+            }
+
+            if (threads == 1)
+                oneThreadTime = parallelTime;
+
+            VRM_LOG_INFO("Benchmark {}: parallel batch Delaunay triangulation with {} threads {:.6f} s, speedup {:.2f}",
+                file.path().filename().string(), threads, parallelTime, oneThreadTime / parallelTime);
+        }
+    }
 
-    return vertexCount;
+    updateTriangularMesh();
 }
 
-void TriangulationScene::fixHeights(std::ifstream& ifs)
+void TriangulationScene::setupTriangulation(std::span<const glm::vec3> points)
 {
-    ifs.clear();
-    ifs.seekg(0);
+    VRM_ASSERT_MSG(points.size() >= 3, "A triangulation needs at least 3 points.");
 
-    std::string line;
-    std::getline(ifs, line);
+    m_TriangularMesh.clear();
 
-    for (size_t i = 0; std::getline(ifs, line); ++i)
+    std::array<size_t, 3> vertexIndices;
+    std::array<glm::dvec2, 3> vertices;
+    for (uint8_t i = 0; i < 3; ++i)
     {
-        std::stringstream sstream(line);
-        std::string token;
+        vertices[i] = glm::dvec2(points[i].x, -points[i].z);
+        vertexIndices[i] = m_TriangularMesh.addVertex({ points[i] });
+    }
 
-        sstream >> token;
-        sstream >> token;
-        sstream >> token;
+    if (Predicates::Orient2D(vertices[0], vertices[1], vertices[2]) > 0.0)
+        m_TriangularMesh.addFirstFaceForTriangulation(vertexIndices[0], vertexIndices[1], vertexIndices[2]);
+    else
+        m_TriangularMesh.addFirstFaceForTriangulation(vertexIndices[0], vertexIndices[2], vertexIndices[1]);
+}
 
+void TriangulationScene::fixHeights(const std::vector<float>& heights)
+{
+    for (size_t i = 0; i < heights.size(); ++i)
+    {
         size_t index = i;
         if (i > 2) index = index + 1; // Because of infinite vertex
-
-        m_TriangularMesh.getVertex(index).position.y = std::stof(token);
+        m_TriangularMesh.getVertex(index).position.y = heights[i];
     }
 }
 
@@ -451,4 +730,43 @@ void TriangulationScene::updateTriangularMesh()
 
     auto e = getEntity("TriangularMesh");
     e.getComponent<vrm::MeshComponent>().setMesh(m_TriangularMeshAsset.createInstance());
+
+    updateVoronoiDiagram();
+}
+
+void TriangulationScene::updateVoronoiDiagram()
+{
+    if (entityExists("VoronoiDiagram"))
+        destroyEntity(getEntity("VoronoiDiagram"));
+
+    if (!m_ShowVoronoiDiagram || m_TriangulationMode == TriangulationMode::NAIVE)
+        return;
+
+    // Bounding box of the finite vertices, with a margin for the unbounded cells
+    glm::vec2 boxMin(std::numeric_limits<float>::max());
+    glm::vec2 boxMax(std::numeric_limits<float>::lowest());
+    float height = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < m_TriangularMesh.getVertexCount(); i++)
+    {
+        if (m_TriangularMesh.isVertexFree(i) || m_TriangularMesh.isVertexInfinite(i))
+            continue;
+
+        const glm::vec3& p = m_TriangularMesh.getVertex(i).position;
+        boxMin = glm::min(boxMin, glm::vec2(p.x, p.z));
+        boxMax = glm::max(boxMax, glm::vec2(p.x, p.z));
+        height = std::max(height, p.y);
+    }
+
+    if (boxMin.x >= boxMax.x || boxMin.y >= boxMax.y)
+        return;
+
+    const float margin = 0.1f * glm::length(boxMax - boxMin);
+    const auto diagram = m_TriangularMesh.computeVoronoiDiagram(boxMin - margin, boxMax + margin, static_cast<size_t>(m_ThreadCount));
+
+    // Slightly above the terrain
+    m_VoronoiDiagramAsset.clear();
+    m_VoronoiDiagramAsset.addSubmesh(diagram.toMeshData(height + 0.01f * margin, 0.005f * margin));
+
+    auto e = createEntity("VoronoiDiagram");
+    e.addComponent<vrm::MeshComponent>(m_VoronoiDiagramAsset.createInstance());
 }
\ No newline at end of file
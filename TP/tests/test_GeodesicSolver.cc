@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "GeodesicSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Flat Delaunay mesh of a jittered grid, whose cotangent weights are all positive
+    TriangularMesh JitteredGrid(int side, float step)
+    {
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> jitter(-0.2f * step, 0.2f * step);
+
+        std::vector<glm::vec3> points;
+        for (int i = 0; i < side; i++)
+            for (int j = 0; j < side; j++)
+                points.emplace_back(i * step + (i % (side - 1) ? jitter(random) : 0.f), 0.f, j * step + (j % (side - 1) ? jitter(random) : 0.f));
+
+        TriangularMesh mesh;
+        mesh.buildDelaunay(points);
+        return mesh;
+    }
+
+    GeodesicSolver::Index NearestVertex(const TriangularMesh& mesh, const glm::vec3& point)
+    {
+        GeodesicSolver::Index nearest = 0;
+        for (GeodesicSolver::Index v = 0; v < mesh.getVertexCount(); v++)
+            if (!mesh.isVertexInfinite(v) && glm::length(mesh.getVertex(v).position - point) < glm::length(mesh.getVertex(nearest).position - point))
+                nearest = v;
+
+        return nearest;
+    }
+
+    // Relative error against the Euclidean distance to the nearest source, away from the sources
+    void ExpectEuclidean(const TriangularMesh& mesh, const std::vector<glm::vec3>& sourcePoints, float meanTolerance, float maxTolerance)
+    {
+        const GeodesicSolver solver(mesh);
+
+        std::vector<GeodesicSolver::Index> sources;
+        for (const glm::vec3& p : sourcePoints)
+            sources.push_back(NearestVertex(mesh, p));
+
+        std::vector<float> distances(solver.getVertexCount());
+        solver.computeDistances(sources, distances);
+
+        for (const GeodesicSolver::Index s : sources)
+            EXPECT_NEAR(distances[s], 0.f, 1e-3f);
+
+        double sumErrors = 0.0;
+        double maxError = 0.0;
+        size_t count = 0;
+
+        for (GeodesicSolver::Index v = 0; v < mesh.getVertexCount(); v++)
+        {
+            if (mesh.isVertexInfinite(v))
+                continue;
+
+            float euclidean = std::numeric_limits<float>::infinity();
+            for (const GeodesicSolver::Index s : sources)
+                euclidean = std::min(euclidean, glm::length(mesh.getVertex(v).position - mesh.getVertex(s).position));
+
+            if (euclidean < 10.f)
+                continue;
+
+            const double error = std::abs(distances[v] - euclidean) / euclidean;
+            sumErrors += error;
+            maxError = std::max(maxError, error);
+            count++;
+        }
+
+        ASSERT_GT(count, 0);
+        EXPECT_LT(sumErrors / count, meanTolerance);
+        EXPECT_LT(maxError, maxTolerance);
+    }
+}
+
+TEST(GeodesicSolver, CenteredSource)
+{
+    ExpectEuclidean(JitteredGrid(101, 2.f), { glm::vec3(100.f, 0.f, 100.f) }, 0.02f, 0.05f);
+}
+
+// Far from the source, the heat is too small for floats
+TEST(GeodesicSolver, OffCenterSource)
+{
+    ExpectEuclidean(JitteredGrid(101, 2.f), { glm::vec3(40.f, 0.f, 140.f) }, 0.02f, 0.05f);
+}
+
+// The distance is smoothed where the nearest source changes
+TEST(GeodesicSolver, SeveralSources)
+{
+    ExpectEuclidean(JitteredGrid(101, 2.f), { glm::vec3(50.f, 0.f, 100.f), glm::vec3(150.f, 0.f, 100.f), glm::vec3(20.f, 0.f, 20.f) }, 0.02f, 0.1f);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "SparseCholesky.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+    TriangularMesh Queen()
+    {
+        TriangularMesh mesh;
+        mesh.loadOFF("Resources/OffFiles/queen.off");
+        return mesh;
+    }
+
+    // Ten times the mean vertex area, a few squared edge lengths
+    float TimeStep(const CotanLaplacian& laplacian)
+    {
+        const auto areas = laplacian.getVertexAreas();
+        return 10.f * std::accumulate(areas.begin(), areas.end(), 0.f) / areas.size();
+    }
+}
+
+TEST(SparseCholesky, DiffuseMatchesConjugateGradient)
+{
+    const TriangularMesh mesh = Queen();
+    ASSERT_GT(mesh.getVertexCount(), 0);
+
+    const CotanLaplacian laplacian(mesh);
+    const size_t n = laplacian.getVertexCount();
+    const float timeStep = TimeStep(laplacian);
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> value(0.f, 1.f);
+
+    std::vector<float> heat(n);
+    for (float& h : heat)
+        h = value(random);
+
+    std::vector<SparseCholesky::Index> fixedVertices;
+    for (SparseCholesky::Index v = 0; v < n; v += 97)
+    {
+        fixedVertices.push_back(v);
+        heat[v] = 1.f;
+    }
+
+    SparseCholesky cholesky;
+    ASSERT_TRUE(cholesky.factorize(laplacian, timeStep, fixedVertices));
+
+    std::vector<float> direct(n);
+    cholesky.diffuse(heat, direct);
+
+    std::vector<float> iterative(heat);
+    laplacian.diffuse(heat, timeStep, iterative, fixedVertices, 1e-7f, 5000);
+
+    for (const SparseCholesky::Index v : fixedVertices)
+        EXPECT_EQ(direct[v], heat[v]);
+
+    float maxDifference = 0.f;
+    for (size_t i = 0; i < n; i++)
+        maxDifference = std::max(maxDifference, std::abs(direct[i] - iterative[i]));
+
+    EXPECT_LT(maxDifference, 1e-6f);
+}
+
+TEST(SparseCholesky, RefactorizedWhenValuesOrTimeStepChange)
+{
+    TriangularMesh mesh = Queen();
+    ASSERT_GT(mesh.getVertexCount(), 0);
+
+    CotanLaplacian laplacian(mesh);
+    const float timeStep = TimeStep(laplacian);
+    const std::vector<SparseCholesky::Index> fixedVertices = { 0, 1000 };
+
+    SparseCholesky cholesky;
+    EXPECT_TRUE(cholesky.factorize(laplacian, timeStep, fixedVertices));
+    EXPECT_TRUE(cholesky.isFactorized(laplacian, timeStep, fixedVertices));
+    EXPECT_FALSE(cholesky.factorize(laplacian, timeStep, fixedVertices));
+
+    EXPECT_FALSE(cholesky.isFactorized(laplacian, 2.f * timeStep, fixedVertices));
+    EXPECT_TRUE(cholesky.factorize(laplacian, 2.f * timeStep, fixedVertices));
+
+    // Moving a vertex changes the weights around it, so the checksum of the values
+    const uint64_t valuesChecksum = laplacian.getValuesChecksum();
+    mesh.getVertex(500).position *= 1.01f;
+    laplacian.assemble(mesh);
+    ASSERT_NE(laplacian.getValuesChecksum(), valuesChecksum);
+
+    EXPECT_FALSE(cholesky.isFactorized(laplacian, 2.f * timeStep, fixedVertices));
+    EXPECT_TRUE(cholesky.factorize(laplacian, 2.f * timeStep, fixedVertices));
+    EXPECT_TRUE(cholesky.isFactorized(laplacian, 2.f * timeStep, fixedVertices));
+}
@@ -0,0 +1,548 @@
+#include <gtest/gtest.h>
+
+#include "TriangularMesh.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<glm::vec3> RandomPoints(size_t count, unsigned int seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> coordinate(-100.f, 100.f);
+
+        std::vector<glm::vec3> points;
+        for (size_t i = 0; i < count; i++)
+            points.emplace_back(coordinate(random), coordinate(random) * 0.1f, coordinate(random));
+
+        return points;
+    }
+
+    // Points repeating every seventh point of the first ones, at the end
+    std::vector<glm::vec3> PointsWithDuplicates()
+    {
+        std::vector<glm::vec3> points = RandomPoints(2000, 1);
+        for (size_t i = 0; i < 200; i++)
+            points.push_back(points[7 * i]);
+
+        return points;
+    }
+
+    // Grid points in a random order: most of them fall exactly on an edge, or on the hull
+    std::vector<glm::vec3> ShuffledGrid(int side)
+    {
+        std::vector<glm::vec3> points;
+        for (int i = 0; i < side; i++)
+            for (int j = 0; j < side; j++)
+                points.emplace_back(i, 0.f, j);
+
+        std::shuffle(points.begin(), points.end(), std::mt19937(3));
+        return points;
+    }
+
+    // Finite faces which are not strictly counterclockwise in the plane
+    size_t FlatFacesCount(const TriangularMesh& mesh)
+    {
+        size_t count = 0;
+        for (size_t f = 0; f < mesh.getFaceCount(); f++)
+        {
+            const auto& indices = mesh.getFace(f).indices;
+            if (mesh.isFaceInfinite(f) || indices[0] == indices[1])
+                continue;
+
+            const glm::dvec3 a(mesh.getVertex(indices[0]).position);
+            const glm::dvec3 b(mesh.getVertex(indices[1]).position);
+            const glm::dvec3 c(mesh.getVertex(indices[2]).position);
+            count += (b.x - a.x) * (a.z - c.z) - (a.z - b.z) * (c.x - a.x) <= 0.0;
+        }
+
+        return count;
+    }
+
+    size_t FiniteFacesCount(const TriangularMesh& mesh)
+    {
+        size_t count = 0;
+        for (size_t f = 0; f < mesh.getFaceCount(); f++)
+            count += !mesh.isFaceInfinite(f) && mesh.getFace(f).indices[0] != mesh.getFace(f).indices[1];
+
+        return count;
+    }
+
+    void ExpectGridTriangulated(TriangularMesh::InsertionKernel kernel)
+    {
+        const int side = 60;
+        const std::vector<glm::vec3> corner = { glm::vec3(0.f, 0.f, 0.f), glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 1.f) };
+
+        TriangularMesh mesh;
+        mesh.buildDelaunay(corner);
+        mesh.insertPoints(ShuffledGrid(side), kernel);
+
+        EXPECT_NO_THROW(mesh.integrityTest());
+        EXPECT_EQ(FlatFacesCount(mesh), 0);
+
+        // 2n - 2 - h triangles, with the h vertices of the hull
+        EXPECT_EQ(FiniteFacesCount(mesh), 2 * side * side - 2 - 4 * (side - 1));
+    }
+
+    size_t ConstrainedEdgesCount(const TriangularMesh& mesh)
+    {
+        size_t count = 0;
+        for (size_t f = 0; f < mesh.getFaceCount(); f++)
+            for (glm::length_t j = 0; j < 3; j++)
+                count += mesh.isEdgeConstrained(f, j);
+
+        // Each edge is seen from both of its faces
+        return count / 2;
+    }
+
+    // Points of a terrain file, the first line being their count, then x, z and the height on each line
+    std::vector<glm::vec3> TerrainPoints(const std::string& name)
+    {
+        std::ifstream file("Resources/TerrainData/" + name + ".txt");
+
+        size_t count = 0;
+        file >> count;
+
+        std::vector<glm::vec3> points(count);
+        for (glm::vec3& p : points)
+            file >> p.x >> p.z >> p.y;
+
+        return file ? points : std::vector<glm::vec3>();
+    }
+
+    glm::dvec2 PlanePosition(const TriangularMesh& mesh, TriangularMesh::Index v)
+    {
+        const glm::vec3 p = mesh.getVertex(v).position;
+        return glm::dvec2(p.x, -p.z);
+    }
+
+    double MinAngle(const glm::dvec2 (&p)[3])
+    {
+        double minAngle = 180.0;
+        for (int i = 0; i < 3; i++)
+        {
+            const glm::dvec2 a = p[(i + 1) % 3] - p[i];
+            const glm::dvec2 b = p[(i + 2) % 3] - p[i];
+            minAngle = std::min(minAngle, glm::degrees(std::acos(std::clamp(glm::dot(a, b) / std::sqrt(glm::dot(a, a) * glm::dot(b, b)), -1.0, 1.0))));
+        }
+
+        return minAngle;
+    }
+
+    // Finite faces with an angle under minAngle degrees. If hullExcused, the faces whose circumcenter lies beyond a hull
+    // edge or inside its diametral circle are not counted, since refine leaves them when the edge has no split point.
+    size_t SharpFacesCount(const TriangularMesh& mesh, float minAngle, bool hullExcused)
+    {
+        std::vector<std::pair<glm::dvec2, glm::dvec2>> hull;
+        for (size_t f = 0; f < mesh.getFaceCount(); f++)
+        {
+            const auto& face = mesh.getFace(f);
+            if (mesh.isFaceInfinite(f) || face.indices[0] == face.indices[1])
+                continue;
+
+            for (glm::length_t j = 0; j < 3; j++)
+                if (mesh.isFaceInfinite(face.neighbours[j]))
+                    hull.emplace_back(PlanePosition(mesh, face.indices[(j + 1) % 3]), PlanePosition(mesh, face.indices[(j + 2) % 3]));
+        }
+
+        size_t count = 0;
+        for (size_t f = 0; f < mesh.getFaceCount(); f++)
+        {
+            const auto& indices = mesh.getFace(f).indices;
+            if (mesh.isFaceInfinite(f) || indices[0] == indices[1])
+                continue;
+
+            const glm::dvec2 p[3] = { PlanePosition(mesh, indices[0]), PlanePosition(mesh, indices[1]), PlanePosition(mesh, indices[2]) };
+            if (MinAngle(p) >= minAngle - 1e-3)
+                continue;
+
+            const glm::dvec2 b = p[1] - p[0];
+            const glm::dvec2 c = p[2] - p[0];
+            const glm::dvec2 center = p[0] + glm::dvec2(c.y * glm::dot(b, b) - b.y * glm::dot(c, c), b.x * glm::dot(c, c) - c.x * glm::dot(b, b)) / (2.0 * (b.x * c.y - b.y * c.x));
+
+            // The hull edges are counterclockwise, the inside is on their left
+            const bool isExcused = hullExcused && std::any_of(hull.begin(), hull.end(), [&center](const auto& edge)
+            {
+                const glm::dvec2 e = edge.second - edge.first;
+                const glm::dvec2 d = center - edge.first;
+                return e.x * d.y - e.y * d.x <= 0.0 || glm::dot(edge.first - center, edge.second - center) < 0.0;
+            });
+
+            count += !isExcused;
+        }
+
+        return count;
+    }
+
+    // Points on a grid of step 1/64 inside a square, with the corners of the square: the hull and diagonal segments
+    // can be split in their middle many times with floats
+    std::vector<glm::vec3> SquareWithGridPoints(size_t count, unsigned int seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> coordinate(-64 * 99, 64 * 99);
+
+        std::vector<glm::vec3> points = {
+            glm::vec3(-100.f, 0.f, -100.f), glm::vec3(100.f, 0.f, -100.f), glm::vec3(100.f, 0.f, 100.f), glm::vec3(-100.f, 0.f, 100.f),
+            glm::vec3(0.f, 0.f, -50.f), glm::vec3(50.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 50.f), glm::vec3(-50.f, 0.f, 0.f)
+        };
+        for (size_t i = 0; i < count; i++)
+            points.emplace_back(coordinate(random) / 64.f, 0.f, coordinate(random) / 64.f);
+
+        return points;
+    }
+
+    // Edges between two finite faces which are not Delaunay
+    size_t NonDelaunayEdgesCount(const TriangularMesh& mesh)
+    {
+        size_t count = 0;
+        for (size_t f = 0; f < mesh.getFaceCount(); f++)
+        {
+            const auto& face = mesh.getFace(f);
+            if (mesh.isFaceInfinite(f) || face.indices[0] == face.indices[1])
+                continue;
+
+            for (glm::length_t j = 0; j < 3; j++)
+                count += !mesh.isFaceInfinite(face.neighbours[j]) && !mesh.isEdgeDelaunay(f, j);
+        }
+
+        return count;
+    }
+
+    // Finite faces, each one starting from its smallest vertex index, in lexicographic order
+    std::vector<std::array<TriangularMesh::Index, 3>> SortedTriangles(const TriangularMesh& mesh)
+    {
+        std::vector<std::array<TriangularMesh::Index, 3>> triangles;
+        for (size_t f = 0; f < mesh.getFaceCount(); f++)
+        {
+            const auto& indices = mesh.getFace(f).indices;
+            if (mesh.isFaceInfinite(f) || indices[0] == indices[1])
+                continue;
+
+            const glm::length_t k = static_cast<glm::length_t>(std::min_element(&indices[0], &indices[0] + 3) - &indices[0]);
+            triangles.push_back({ indices[k], indices[(k + 1) % 3], indices[(k + 2) % 3] });
+        }
+
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // One point of each pair is triangulated, the other one stays free
+    void ExpectDuplicatesFree(const TriangularMesh& mesh)
+    {
+        size_t freeCount = 0;
+        for (size_t i = 0; i < 2200; i++)
+            freeCount += mesh.isVertexFree(i);
+
+        EXPECT_EQ(freeCount, 200);
+
+        for (size_t i = 0; i < 200; i++)
+            EXPECT_NE(mesh.isVertexFree(7 * i), mesh.isVertexFree(2000 + i));
+    }
+}
+
+TEST(BuildDelaunay, DuplicatesAreFree)
+{
+    TriangularMesh mesh;
+    mesh.buildDelaunay(PointsWithDuplicates());
+
+    EXPECT_NO_THROW(mesh.integrityTest());
+    ExpectDuplicatesFree(mesh);
+}
+
+TEST(BuildDelaunayParallel, DuplicatesAreFree)
+{
+    TriangularMesh mesh;
+    mesh.buildDelaunayParallel(PointsWithDuplicates(), 4);
+
+    EXPECT_NO_THROW(mesh.integrityTest());
+    ExpectDuplicatesFree(mesh);
+}
+
+TEST(BuildDelaunayParallel, SameTrianglesAsBuildDelaunay)
+{
+    const std::vector<glm::vec3> points = RandomPoints(20'000, 5);
+
+    TriangularMesh expected;
+    expected.buildDelaunay(points);
+    const auto expectedTriangles = SortedTriangles(expected);
+
+    for (size_t threadCount : { 2, 3, 4, 8, 16 })
+    {
+        TriangularMesh mesh;
+        mesh.buildDelaunayParallel(points, threadCount);
+
+        EXPECT_NO_THROW(mesh.integrityTest());
+        EXPECT_EQ(SortedTriangles(mesh), expectedTriangles) << threadCount << " threads";
+    }
+}
+
+TEST(InsertPoints, GridWithFlips)
+{
+    ExpectGridTriangulated(TriangularMesh::InsertionKernel::FLIPS);
+}
+
+TEST(InsertPoints, GridWithBowyerWatson)
+{
+    ExpectGridTriangulated(TriangularMesh::InsertionKernel::BOWYER_WATSON);
+}
+
+TEST(InsertConstraint, RejectedThroughVertexLeavesNoPart)
+{
+    // The segment from 0 to 2 goes through 1, and its part from 1 to 2 crosses the constraint from 5 to 6
+    const std::vector<glm::vec3> points = {
+        glm::vec3(0.f, 0.f, 0.f), glm::vec3(10.f, 0.f, 0.f), glm::vec3(20.f, 0.f, 0.f),
+        glm::vec3(5.f, 0.f, 5.f), glm::vec3(5.f, 0.f, -5.f), glm::vec3(15.f, 0.f, 5.f), glm::vec3(15.f, 0.f, -5.f)
+    };
+
+    TriangularMesh mesh;
+    mesh.buildDelaunay(points);
+
+    ASSERT_TRUE(mesh.insertConstraint(5, 6));
+    EXPECT_FALSE(mesh.insertConstraint(0, 2));
+
+    EXPECT_NO_THROW(mesh.integrityTest());
+    EXPECT_EQ(ConstrainedEdgesCount(mesh), 1);
+}
+
+TEST(RemoveVertex, InteriorAndHullVertices)
+{
+    TriangularMesh mesh;
+    mesh.buildDelaunay(RandomPoints(500, 9));
+
+    std::vector<bool> isOnHull(mesh.getVertexCount(), false);
+    for (size_t f = 0; f < mesh.getFaceCount(); f++)
+        if (mesh.isFaceInfinite(f))
+            for (glm::length_t j = 0; j < 3; j++)
+                if (!mesh.isVertexInfinite(mesh.getFace(f).indices[j]))
+                    isOnHull[mesh.getFace(f).indices[j]] = true;
+
+    std::vector<size_t> removed;
+    for (size_t v = 0; v < 500 && removed.size() < 20; v += 7)
+        if (!isOnHull[v])
+            removed.push_back(v);
+    for (size_t v = 0; v < 500 && removed.size() < 25; v++)
+        if (isOnHull[v])
+            removed.push_back(v);
+
+    ASSERT_EQ(removed.size(), 25);
+
+    const size_t vertexCount = mesh.getVertexCount();
+    const size_t faceCount = mesh.getFaceCount();
+
+    // Free faces have all their vertices on the infinite vertex
+    auto usedFacesCount = [&mesh]() {
+        size_t count = 0;
+        for (size_t f = 0; f < mesh.getFaceCount(); f++)
+            count += mesh.getFace(f).indices[0] != mesh.getFace(f).indices[1];
+        return count;
+    };
+
+    for (size_t i = 0; i < removed.size(); i++)
+    {
+        SCOPED_TRACE(removed[i]);
+        mesh.removeVertex(removed[i]);
+
+        EXPECT_TRUE(mesh.isVertexFree(removed[i]));
+        EXPECT_NO_THROW(mesh.integrityTest());
+        EXPECT_EQ(NonDelaunayEdgesCount(mesh), 0);
+        EXPECT_EQ(FlatFacesCount(mesh), 0);
+
+        // Each removal frees two faces, on the hull too
+        EXPECT_EQ(usedFacesCount(), faceCount - 2 * (i + 1));
+    }
+
+    // The freed vertex and face slots are reused before the arrays grow
+    for (size_t i = 0; i < removed.size(); i++)
+        mesh.addVertex_StreamingDelaunayTriangulation(glm::vec3(-50.f + 4.f * i, 0.f, 3.f * i - 40.f));
+
+    EXPECT_EQ(mesh.getVertexCount(), vertexCount);
+    EXPECT_EQ(mesh.getFaceCount(), faceCount);
+    EXPECT_NO_THROW(mesh.integrityTest());
+    EXPECT_EQ(NonDelaunayEdgesCount(mesh), 0);
+
+    for (size_t v : removed)
+        EXPECT_FALSE(mesh.isVertexFree(v));
+}
+
+TEST(InsertBreaklines, BadLinesAreSkipped)
+{
+    // Point 5 is a duplicate of point 0, so it stays free, and the infinite vertex is 6
+    const std::vector<glm::vec3> points = {
+        glm::vec3(0.f, 0.f, 0.f), glm::vec3(10.f, 0.f, 0.f), glm::vec3(10.f, 0.f, 10.f), glm::vec3(0.f, 0.f, 10.f),
+        glm::vec3(5.f, 0.f, 2.f), glm::vec3(0.f, 0.f, 0.f)
+    };
+
+    TriangularMesh mesh;
+    mesh.buildDelaunay(points);
+
+    const std::filesystem::path path = std::filesystem::path(testing::TempDir()) / "bad_indices.breaklines";
+    std::ofstream(path) << "7\n0 4\n1 9\n\n2 6\n5 3\nx 3\n2\n1 3\n";
+
+    size_t segmentCount = 0;
+    EXPECT_EQ(mesh.insertBreaklines(path, nullptr, &segmentCount), 2);
+    EXPECT_EQ(segmentCount, 7);
+
+    EXPECT_NO_THROW(mesh.integrityTest());
+    EXPECT_EQ(ConstrainedEdgesCount(mesh), 2);
+
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryCache, RoundTrip)
+{
+    const std::filesystem::path path = std::filesystem::path(testing::TempDir()) / "round_trip.tpmesh";
+
+    TriangularMesh mesh;
+    mesh.buildDelaunay(RandomPoints(2000, 6));
+    mesh.removeVertex(10);
+    ASSERT_TRUE(mesh.saveBinary(path, 42));
+
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    EXPECT_FALSE(std::filesystem::exists(tempPath));
+
+    TriangularMesh loaded;
+    ASSERT_TRUE(loaded.loadBinary(path, 42));
+
+    EXPECT_NO_THROW(loaded.integrityTest());
+    EXPECT_EQ(loaded.getVertexCount(), mesh.getVertexCount());
+    EXPECT_EQ(loaded.getFaceCount(), mesh.getFaceCount());
+    EXPECT_EQ(SortedTriangles(loaded), SortedTriangles(mesh));
+
+    // The freed slots are saved too, and reused in the same order
+    mesh.addVertex_StreamingDelaunayTriangulation(glm::vec3(1.f, 0.f, 2.f));
+    loaded.addVertex_StreamingDelaunayTriangulation(glm::vec3(1.f, 0.f, 2.f));
+    EXPECT_EQ(loaded.getVertexCount(), mesh.getVertexCount());
+    EXPECT_EQ(SortedTriangles(loaded), SortedTriangles(mesh));
+
+    std::filesystem::remove(path);
+}
+
+TEST(BinaryCache, OtherSourceOrCorruptionRejected)
+{
+    const std::filesystem::path path = std::filesystem::path(testing::TempDir()) / "rejected.tpmesh";
+
+    TriangularMesh mesh;
+    mesh.buildDelaunay(RandomPoints(2000, 7));
+    ASSERT_TRUE(mesh.saveBinary(path, 42));
+
+    // A rejected cache leaves the mesh untouched
+    TriangularMesh other;
+    other.buildDelaunay(RandomPoints(100, 8));
+    const auto otherTriangles = SortedTriangles(other);
+
+    EXPECT_FALSE(other.loadBinary(path, 43));
+    EXPECT_EQ(SortedTriangles(other), otherTriangles);
+
+    // One flipped bit in the last face
+    {
+        std::fstream file(path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        file.seekg(-4, std::ios_base::end);
+        const char c = static_cast<char>(file.get() ^ 1);
+        file.seekp(-4, std::ios_base::end);
+        file.put(c);
+    }
+
+    EXPECT_FALSE(other.loadBinary(path, 42));
+    EXPECT_EQ(SortedTriangles(other), otherTriangles);
+
+    std::filesystem::remove(path);
+}
+
+TEST(Refine, TerrainsStayCounterclockwise)
+{
+    for (const char* name : { "alpes_poisson", "alpes_random_1", "alpes_random_2", "noise_poisson", "noise_random_1", "noise_random_2" })
+    {
+        SCOPED_TRACE(name);
+
+        const std::vector<glm::vec3> points = TerrainPoints(name);
+        ASSERT_FALSE(points.empty());
+
+        for (const float minAngle : { 15.f, 20.f })
+        {
+            TriangularMesh mesh;
+            mesh.buildDelaunay(points);
+
+            EXPECT_LT(mesh.refine(minAngle, std::numeric_limits<float>::infinity(), 100'000), 100'000);
+            EXPECT_NO_THROW(mesh.integrityTest());
+            EXPECT_EQ(FlatFacesCount(mesh), 0);
+
+            // The hull edges of the terrains are too far from float points to be split exactly down to the minimum angle
+            EXPECT_EQ(SharpFacesCount(mesh, minAngle, true), 0);
+        }
+    }
+}
+
+TEST(Refine, MinAngleWithSegments)
+{
+    for (unsigned int seed = 0; seed < 5; seed++)
+    {
+        SCOPED_TRACE(seed);
+
+        TriangularMesh mesh;
+        mesh.buildDelaunay(SquareWithGridPoints(2000, seed));
+
+        // A diamond of constraints in the middle
+        for (TriangularMesh::Index i = 0; i < 4; i++)
+            ASSERT_TRUE(mesh.insertConstraint(4 + i, 4 + (i + 1) % 4));
+
+        EXPECT_LT(mesh.refine(25.f, 5.f, 100'000), 100'000);
+        EXPECT_NO_THROW(mesh.integrityTest());
+        EXPECT_EQ(FlatFacesCount(mesh), 0);
+        EXPECT_EQ(SharpFacesCount(mesh, 25.f, false), 0);
+    }
+}
+
+TEST(VoronoiDiagram, SharedEdgesDrawnOnce)
+{
+    TriangularMesh mesh;
+    mesh.buildDelaunay(RandomPoints(500, 2));
+
+    const auto diagram = mesh.computeVoronoiDiagram(glm::vec2(-80.f), glm::vec2(80.f), 4);
+    ASSERT_EQ(diagram.cellNeighbours.size(), diagram.cellVertices.size());
+
+    size_t sharedEdgesCount = 0;
+    size_t boxEdgesCount = 0;
+
+    for (TriangularMesh::Index v = 0; v + 1 < diagram.cellOffsets.size(); v++)
+    {
+        const TriangularMesh::Index begin = diagram.cellOffsets[v];
+        const TriangularMesh::Index end = diagram.cellOffsets[v + 1];
+
+        double doubleArea = 0.0;
+        for (TriangularMesh::Index k = begin; k < end; k++)
+        {
+            const glm::dvec2 a(diagram.vertices[diagram.cellVertices[k]]);
+            const glm::dvec2 b(diagram.vertices[diagram.cellVertices[k + 1 < end ? k + 1 : begin]]);
+            doubleArea += a.x * b.y - a.y * b.x;
+
+            const TriangularMesh::Index neighbour = diagram.cellNeighbours[k];
+            if (neighbour == TriangularMesh::InvalidIndex)
+            {
+                boxEdgesCount++;
+                continue;
+            }
+
+            // The neighbouring cell has the same edge, across from this one
+            const auto first = diagram.cellNeighbours.begin() + diagram.cellOffsets[neighbour];
+            const auto last = diagram.cellNeighbours.begin() + diagram.cellOffsets[neighbour + 1];
+            EXPECT_NE(std::find(first, last, v), last);
+            sharedEdgesCount++;
+        }
+
+        // Clockwise in the (x, z) plane
+        if (begin != end)
+        {
+            EXPECT_LT(doubleArea, 0.0);
+        }
+    }
+
+    EXPECT_EQ(diagram.toMeshData(0.f, 0.1f).getIndexCount(), 6 * (sharedEdgesCount / 2 + boxEdgesCount));
+}
@@ -36,6 +36,11 @@ public:
     void addSubmesh(const MeshData& mesh, MaterialInstance instance);
     void addSubmesh(const MeshData& mesh);
 
+    // Vertices of a submesh can be changed in place, and uploaded again with the same count and indices. Updating a
+    // submesh whose vertex count changed is an assertion failure.
+    MeshData& getSubmeshData(size_t index) { return m_SubMeshes.at(index).meshData; }
+    void updateSubmeshVertices(size_t index);
+
     void clear();
 
 protected: 
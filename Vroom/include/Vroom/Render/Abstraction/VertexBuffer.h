@@ -22,6 +22,14 @@ public:
 	 */
 	virtual ~VertexBuffer();
 
+	/**
+	 * @brief Overwrites a part of the buffer, which keeps its size.
+	 * @param data Raw pointer to the new data.
+	 * @param size Size of data.
+	 * @param offset Offset in the buffer where data is written.
+	 */
+	void setData(const void* data, unsigned int size, unsigned int offset = 0);
+
 	/**
 	 * @brief Binds this vertex buffer.
 	 */
@@ -23,10 +23,15 @@ public:
 
     ~RenderMesh();
 
+    // Uploads the vertices again, meshData must have the vertex count of the mesh it was created from
+    void updateVertices(const MeshData& meshData);
+
     const VertexArray& getVertexArray() const { return m_VertexArray; }
     const IndexBuffer& getIndexBuffer() const { return m_IndexBuffer; }
+    size_t getVertexCount() const { return m_VertexCount; }
 
 private:
+    size_t m_VertexCount;
     VertexBuffer m_VertexBuffer;
     IndexBuffer m_IndexBuffer;
     VertexArray m_VertexArray;
@@ -41,6 +41,14 @@ void MeshAsset::addSubmesh(const MeshData& mesh)
     m_SubMeshes.emplace_back(SubMesh(RenderMesh(mesh), MeshData(mesh), materialInstance));
 }
 
+void MeshAsset::updateSubmeshVertices(size_t index)
+{
+    SubMesh& subMesh = m_SubMeshes.at(index);
+    VRM_ASSERT_MSG(subMesh.meshData.getVertexCount() == subMesh.renderMesh.getVertexCount(), "Vertices of submesh {} were added or removed, it can only be changed in place.", index);
+
+    subMesh.renderMesh.updateVertices(subMesh.meshData);
+}
+
 void MeshAsset::clear()
 {
     m_SubMeshes.clear();
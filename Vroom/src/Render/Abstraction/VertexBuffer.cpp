@@ -32,6 +32,12 @@ VertexBuffer::~VertexBuffer()
 	GLCall_nothrow(glDeleteBuffers(1, &m_RendererID));
 }
 
+void VertexBuffer::setData(const void* data, unsigned int size, unsigned int offset)
+{
+	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+	GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
 void VertexBuffer::bind() const
 {
 	GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
@@ -1,12 +1,14 @@
 #include "Vroom/Render/RenderObject/RenderMesh.h"
 
 #include "Vroom/Core/Log.h"
+#include "Vroom/Core/Assert.h"
 
 namespace vrm
 {
 
 RenderMesh::RenderMesh(const MeshData& meshData)
-    : m_VertexBuffer(meshData.getRawVericesData(), (unsigned int)meshData.getVertexCount() * sizeof(Vertex)),
+    : m_VertexCount(meshData.getVertexCount()),
+      m_VertexBuffer(meshData.getRawVericesData(), (unsigned int)meshData.getVertexCount() * sizeof(Vertex)),
       m_IndexBuffer(meshData.getRawIndicesData(), (unsigned int)meshData.getIndexCount())
 {
     m_VertexBufferLayout.pushFloat(3);
@@ -18,7 +20,8 @@ RenderMesh::RenderMesh(const MeshData& meshData)
 }
 
 RenderMesh::RenderMesh(RenderMesh&& other)
-    : m_VertexBuffer(std::move(other.m_VertexBuffer)),
+    : m_VertexCount(other.m_VertexCount),
+      m_VertexBuffer(std::move(other.m_VertexBuffer)),
       m_IndexBuffer(std::move(other.m_IndexBuffer)),
       m_VertexArray(std::move(other.m_VertexArray)),
       m_VertexBufferLayout(std::move(other.m_VertexBufferLayout))
@@ -29,6 +32,7 @@ RenderMesh& RenderMesh::operator=(RenderMesh&& other)
 {
     if (this != &other)
     {
+        m_VertexCount = other.m_VertexCount;
         m_VertexBuffer = std::move(other.m_VertexBuffer);
         m_IndexBuffer = std::move(other.m_IndexBuffer);
         m_VertexArray = std::move(other.m_VertexArray);
@@ -42,4 +46,10 @@ RenderMesh::~RenderMesh()
 {
 }
 
+void RenderMesh::updateVertices(const MeshData& meshData)
+{
+    VRM_ASSERT_MSG(meshData.getVertexCount() == m_VertexCount, "Vertex count changed from {} to {}, the vertex buffer keeps its size.", m_VertexCount, meshData.getVertexCount());
+    m_VertexBuffer.setData(meshData.getRawVericesData(), (unsigned int)meshData.getVertexCount() * sizeof(Vertex));
+}
+
 } // namespace vrm
\ No newline at end of file
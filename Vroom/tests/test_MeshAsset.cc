@@ -4,6 +4,7 @@
 #include <Vroom/Core/Application.h>
 
 #include <fstream>
+#include <stdexcept>
 
 class TestMeshAsset : public testing::Test
 {
@@ -78,3 +79,40 @@ TEST_F(TestMeshAsset, GetRenderMesh)
     meshAsset->load(pathOK);
     EXPECT_NO_THROW(const vrm::RenderMesh& renderMesh = meshAsset->getSubMeshes().begin()->renderMesh;);
 }
+
+TEST_F(TestMeshAsset, GetSubmeshData)
+{
+    meshAsset->load(pathOK);
+    EXPECT_EQ(&meshAsset->getSubmeshData(0), &meshAsset->getSubMeshes().begin()->meshData);
+    EXPECT_THROW(meshAsset->getSubmeshData(1), std::out_of_range);
+}
+
+TEST_F(TestMeshAsset, UpdateSubmeshVertices)
+{
+    meshAsset->load(pathOK);
+
+    vrm::MeshData& meshData = meshAsset->getSubmeshData(0);
+    for (vrm::Vertex& vertex : meshData.getVertices())
+        vertex.scalar = 1.0f;
+
+    EXPECT_NO_THROW(meshAsset->updateSubmeshVertices(0));
+    EXPECT_EQ(meshAsset->getSubMeshes().begin()->meshData.getVertices()[2].scalar, 1.0f);
+    EXPECT_EQ(meshAsset->getSubMeshes().begin()->renderMesh.getVertexCount(), 3);
+}
+
+TEST_F(TestMeshAsset, UpdateSubmeshVerticesOutOfRange)
+{
+    meshAsset->load(pathOK);
+    EXPECT_THROW(meshAsset->updateSubmeshVertices(1), std::out_of_range);
+}
+
+TEST_F(TestMeshAsset, UpdateSubmeshVerticesCountChanged)
+{
+    meshAsset->load(pathOK);
+
+    // The vertex buffer keeps the size of the three vertices it was created with
+    vrm::MeshData& meshData = meshAsset->getSubmeshData(0);
+    meshData.getVertices().push_back(meshData.getVertices()[0]);
+
+    EXPECT_THROW(meshAsset->updateSubmeshVertices(0), std::runtime_error);
+}